@@ -0,0 +1,129 @@
+#include "AdaptiveTuner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+using namespace pid_control;
+
+
+constexpr unsigned AdaptiveTuner::N;
+
+// Initial covariance; large means little trust in the initial (zero) model
+static constexpr double INITIAL_COVARIANCE = 1000.0;
+// The covariance is re-initialized when its trace exceeds this, which happens when excitation dies out
+static constexpr double MAX_COVARIANCE_TRACE = 1e6;
+// Updates needed before the model is used
+static constexpr unsigned WARMUP_UPDATES = 50u;
+// Smallest steering effect trusted; below it the gains would explode
+static constexpr double MIN_STEERING_EFFECT = 1e-3;
+
+AdaptiveTuner::AdaptiveTuner(double forgetting, double closedLoopPole, double smoothing, double maxGain,
+                             double dither) :
+    m_forgetting(forgetting), m_closedLoopPole(closedLoopPole), m_smoothing(smoothing), m_maxGain(maxGain),
+    m_dither(dither)
+{
+    for (unsigned i = 0u; i < N; ++i)
+    {
+        m_cov[i][i] = INITIAL_COVARIANCE;
+    }
+}
+
+void AdaptiveTuner::Observe(double cte)
+{
+    if (m_haveCommand && m_observed >= 2u)
+    {
+        // RLS update with regressor phi = m_regressor and measurement cte:
+        //   K = P phi / (lambda + phi' P phi)
+        //   theta += K (cte - phi' theta)
+        //   P = (P - K phi' P) / lambda
+        const auto& phi = m_regressor;
+        std::array<double, N> pPhi {};
+        double denominator = m_forgetting;
+        double prediction = 0.0;
+        for (unsigned i = 0u; i < N; ++i)
+        {
+            for (unsigned j = 0u; j < N; ++j)
+            {
+                pPhi[i] += m_cov[i][j] * phi[j];
+            }
+            denominator += phi[i] * pPhi[i];
+            prediction += phi[i] * m_theta[i];
+        }
+
+        const double residual = cte - prediction;
+        double trace = 0.0;
+        for (unsigned i = 0u; i < N; ++i)
+        {
+            m_theta[i] += pPhi[i] / denominator * residual;
+            for (unsigned j = 0u; j < N; ++j)
+            {
+                // P is symmetric, so phi' P = (P phi)'
+                m_cov[i][j] = (m_cov[i][j] - pPhi[i] * pPhi[j] / denominator) / m_forgetting;
+            }
+            trace += m_cov[i][i];
+        }
+
+        if (trace > MAX_COVARIANCE_TRACE || not std::isfinite(trace))
+        {
+            m_cov = {};
+            for (unsigned i = 0u; i < N; ++i)
+            {
+                m_cov[i][i] = INITIAL_COVARIANCE;
+            }
+        }
+        m_updates++;
+    }
+
+    m_regressor[1] = m_regressor[0];
+    m_regressor[0] = cte;
+    m_haveCommand = false;
+    m_observed++;
+}
+
+double AdaptiveTuner::Excite(double steering)
+{
+    // 16 bit Fibonacci LFSR, taps 16 14 13 11
+    const unsigned bit = ((m_lfsr >> 0) ^ (m_lfsr >> 2) ^ (m_lfsr >> 3) ^ (m_lfsr >> 5)) & 1u;
+    m_lfsr = (m_lfsr >> 1) | (bit << 15);
+
+    const double excited = steering + (bit ? m_dither : -m_dither);
+    return std::min(std::max(excited, -1.0), 1.0);
+}
+
+void AdaptiveTuner::OnCommand(double steering)
+{
+    m_regressor[2] = steering;
+    m_haveCommand = true;
+}
+
+void AdaptiveTuner::Restart()
+{
+    m_regressor = {};
+    m_observed = 0u;
+    m_haveCommand = false;
+}
+
+bool AdaptiveTuner::UpdateGains(std::vector<double>& params) const
+{
+    const double a1 = m_theta[0];
+    const double a2 = m_theta[1];
+    const double b = m_theta[2];
+    if (m_updates < WARMUP_UPDATES || b < MIN_STEERING_EFFECT)
+    {
+        return false;
+    }
+
+    // Closed loop: cte[k+1] = (a1 - b (kp + kd)) cte[k] + (a2 + b kd) cte[k-1]
+    // Match its characteristic polynomial to (z - p)^2 = z^2 - 2p z + p^2
+    const double p = m_closedLoopPole;
+    const double kd = -(p * p + a2) / b;
+    const double kp = (a1 - 2.0 * p) / b - kd;
+
+    const double targetKp = std::min(std::max(kp, 0.0), m_maxGain);
+    const double targetKd = std::min(std::max(kd, 0.0), m_maxGain);
+    params[0] += m_smoothing * (targetKp - params[0]);
+    params[2] += m_smoothing * (targetKd - params[2]);
+    return true;
+}
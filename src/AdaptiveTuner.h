@@ -0,0 +1,84 @@
+#ifndef ADAPTIVE_TUNER_H
+#define ADAPTIVE_TUNER_H
+
+#include <array>
+#include <vector>
+
+
+namespace pid_control
+{
+    /*
+    * Online PD gain adaptation, without resetting the simulator.
+    *
+    * A local second order model of the lateral dynamics is identified from streaming telemetry
+    * with recursive least squares (with exponential forgetting):
+    *     cte[k+1] = a1 * cte[k] + a2 * cte[k-1] + b * steering[k]
+    * The proportional and derivative gains are then chosen so that the closed loop with
+    *     steering[k] = -kp * cte[k] - kd * (cte[k] - cte[k-1])
+    * has a double pole at `closedLoopPole`, and the PID gains are moved smoothly towards them.
+    * The integral gain is left as it is.
+    *
+    * Steering computed from the CTE alone makes the regressors collinear (closed loop identification),
+    * so a small pseudo-random binary dither is added to the steering to keep the model identifiable.
+    */
+    class AdaptiveTuner
+    {
+    public:
+        /*
+        * forgetting - RLS forgetting factor in (0, 1], lower adapts faster but is noisier.
+        * closedLoopPole - desired closed loop pole in (0, 1), lower is more aggressive.
+        * smoothing - fraction of the way the gains move towards the identified ones on each tick.
+        * maxGain - upper bound for kp and kd.
+        * dither - amplitude of the probing signal added to the steering.
+        */
+        AdaptiveTuner(double forgetting, double closedLoopPole, double smoothing, double maxGain, double dither);
+
+        /*
+        * Feed the CTE of a new tick. Updates the model with it, given the previous two CTEs and steering.
+        */
+        void Observe(double cte);
+
+        /*
+        * Adds the probing dither to the steering computed by the controller, clamped to [-1, 1].
+        */
+        double Excite(double steering);
+
+        /*
+        * Record the steering actually sent in response to the last observed CTE.
+        */
+        void OnCommand(double steering);
+
+        /*
+        * Moves `params` ({kp, ki, kd}) towards the gains the current model calls for.
+        * Returns false and leaves them untouched while the model is not yet trustworthy.
+        */
+        bool UpdateGains(std::vector<double>& params) const;
+
+        /*
+        * Forget the CTE and steering history, e.g. after the simulator was reset. The model is kept.
+        */
+        void Restart();
+
+        std::array<double, 3> GetModel() const { return m_theta; };
+
+    private:
+        static constexpr unsigned N = 3u;
+
+        const double m_forgetting { 1.0 };
+        const double m_closedLoopPole { 0.9 };
+        const double m_smoothing { 0.01 };
+        const double m_maxGain { 1.0 };
+        const double m_dither { 0.0 };
+
+        std::array<double, N> m_theta {};                // {a1, a2, b}
+        std::array<std::array<double, N>, N> m_cov {};   // Covariance of the estimate
+        std::array<double, N> m_regressor {};            // {cte[k], cte[k-1], steering[k]}
+
+        unsigned m_observed { 0u };   // CTEs seen
+        unsigned m_updates { 0u };    // RLS updates done
+        bool m_haveCommand { false };
+        unsigned m_lfsr { 0xACE1u };  // Dither sequence state
+    };
+}
+
+#endif  // ADAPTIVE_TUNER_H
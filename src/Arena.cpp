@@ -0,0 +1,85 @@
+#include "Arena.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+
+using namespace pid_control;
+
+
+static thread_local Arena* currentArena = nullptr;
+// The last arena made current on this thread, to catch arena pointers freed after it stopped being current
+static thread_local Arena* lastArena = nullptr;
+
+Arena::Arena(size_t bytes) :
+    m_block(new char[bytes]), m_size(bytes)
+{
+}
+
+Arena::~Arena()
+{
+    if (lastArena == this)
+    {
+        lastArena = nullptr;
+    }
+    if (currentArena == this)
+    {
+        currentArena = nullptr;
+    }
+}
+
+Arena* Arena::Current()
+{
+    return currentArena;
+}
+
+void Arena::SetCurrent(Arena* arena)
+{
+    currentArena = arena;
+    lastArena = arena != nullptr ? arena : lastArena;
+}
+
+void Arena::Free(void* pointer)
+{
+    if (currentArena != nullptr)
+    {
+        currentArena->Deallocate(pointer);
+        return;
+    }
+    assert((lastArena == nullptr || not lastArena->Owns(pointer)) && "Arena value destroyed after its arena");
+    ::operator delete(pointer);
+}
+
+void* Arena::Allocate(size_t bytes, size_t alignment)
+{
+    const uintptr_t base = reinterpret_cast<uintptr_t>(m_block.get());
+    const uintptr_t aligned = (base + m_used + alignment - 1u) & ~static_cast<uintptr_t>(alignment - 1u);
+    const size_t end = aligned - base + bytes;
+    if (end > m_size)
+    {
+        m_overflows++;
+        return ::operator new(bytes);
+    }
+
+    m_used = end;
+    m_highWater = std::max(m_highWater, m_used);
+    m_live++;
+    return reinterpret_cast<void*>(aligned);
+}
+
+void Arena::Deallocate(void* pointer)
+{
+    if (not Owns(pointer))
+    {
+        ::operator delete(pointer);
+        return;
+    }
+    m_live--;
+}
+
+void Arena::Reset()
+{
+    assert(m_live == 0u && "Arena reset while allocations are alive");
+    m_used = 0u;
+}
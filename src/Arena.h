@@ -0,0 +1,124 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+
+namespace pid_control
+{
+    /*
+    * Bump allocator over one fixed block. Allocation is a pointer increment, deallocation is free,
+    * and Reset() reclaims everything at once; it must only be called when nothing allocated from it is alive.
+    * Requests that do not fit are served by the global heap and counted as overflows.
+    */
+    class Arena
+    {
+    public:
+        explicit Arena(size_t bytes);
+        ~Arena();
+
+        void* Allocate(size_t bytes, size_t alignment);
+        void Deallocate(void* pointer);
+        void Reset();
+
+        bool Owns(const void* pointer) const
+        {
+            return pointer >= m_block.get() && pointer < m_block.get() + m_size;
+        };
+        size_t Used() const { return m_used; };
+        size_t HighWater() const { return m_highWater; };
+        size_t Overflows() const { return m_overflows; };
+
+        /*
+        * The arena ArenaAllocator draws from on this thread; nullptr uses the global heap.
+        */
+        static Arena* Current();
+        static void SetCurrent(Arena* arena);
+
+        /*
+        * Frees a pointer from ArenaAllocator through the current arena, which hands pointers it does not own
+        * to the heap. With no current arena the pointer must come from the heap; debug builds assert it does
+        * not belong to the arena that was current last.
+        */
+        static void Free(void* pointer);
+
+    private:
+        std::unique_ptr<char[]> m_block;
+        const size_t m_size { 0u };
+        size_t m_used { 0u };
+        size_t m_highWater { 0u };
+        size_t m_live { 0u };
+        size_t m_overflows { 0u };
+    };
+
+    /*
+    * Resets an arena when leaving the scope. Declare it before the values allocated from the arena,
+    * so they are destroyed first.
+    */
+    class ArenaResetGuard
+    {
+    public:
+        explicit ArenaResetGuard(Arena& arena) : m_arena(arena) {};
+        ~ArenaResetGuard() { m_arena.Reset(); };
+
+        ArenaResetGuard(const ArenaResetGuard&) = delete;
+        ArenaResetGuard& operator=(const ArenaResetGuard&) = delete;
+
+    private:
+        Arena& m_arena;
+    };
+
+    /*
+    * Stateless standard allocator over the current thread's arena, so it can be plugged into containers
+    * that default-construct their allocators (e.g. basic_json's AllocatorType).
+    * Being stateless, it only finds the arena again through Current(): values must be destroyed on the
+    * thread and while the arena they were allocated from is still current.
+    */
+    template<typename T>
+    struct ArenaAllocator
+    {
+        using value_type = T;
+
+        ArenaAllocator() = default;
+        template<typename U>
+        ArenaAllocator(const ArenaAllocator<U>&) {}
+
+        T* allocate(size_t count)
+        {
+            Arena* arena = Arena::Current();
+            if (arena == nullptr)
+            {
+                return static_cast<T*>(::operator new(count * sizeof(T)));
+            }
+            return static_cast<T*>(arena->Allocate(count * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* pointer, size_t)
+        {
+            Arena::Free(pointer);
+        }
+
+        // json.hpp calls these directly instead of going through std::allocator_traits
+        template<typename U, typename... Args>
+        void construct(U* pointer, Args&&... args)
+        {
+            ::new (static_cast<void*>(pointer)) U(std::forward<Args>(args)...);
+        }
+
+        template<typename U>
+        void destroy(U* pointer)
+        {
+            pointer->~U();
+        }
+
+        template<typename U>
+        bool operator==(const ArenaAllocator<U>&) const { return true; }
+        template<typename U>
+        bool operator!=(const ArenaAllocator<U>&) const { return false; }
+    };
+}
+
+#endif  // ARENA_H
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "BayesOpt.h"
+#include "GaussianProcess.h"
+
+using namespace pid_control;
+
+
+static constexpr double LENGTH_SCALE = 0.25;      // Kernel length scale in the normalized [0, 1] space
+static constexpr double NOISE_VARIANCE = 0.01;    // Observation noise, relative to the standardized error variance
+static constexpr double EXPLORATION = 0.01;       // Expected improvement margin, in standardized units
+static constexpr unsigned RANDOM_CANDIDATES = 2000u;
+static constexpr unsigned LOCAL_CANDIDATES = 1000u;
+static constexpr double LOCAL_SPREAD = 0.05;
+
+BayesOpt::BayesOpt(const std::vector<double>& lower, const std::vector<double>& upper,
+                   unsigned budget, unsigned batchSize, unsigned seed) :
+	m_lower(lower), m_upper(upper), m_budget(budget), m_batchSize(std::max(batchSize, 1u)), m_rng(seed)
+{}
+
+std::vector<double> BayesOpt::normalize(const std::vector<double>& params) const
+{
+	std::vector<double> unit(params.size());
+	for (size_t i = 0; i < params.size(); ++i)
+	{
+		const double range = m_upper[i] - m_lower[i];
+		unit[i] = range > 0.0 ? std::min(std::max((params[i] - m_lower[i]) / range, 0.0), 1.0) : 0.0;
+	}
+	return unit;
+}
+
+std::vector<double> BayesOpt::denormalize(const std::vector<double>& unit) const
+{
+	std::vector<double> params(unit.size());
+	for (size_t i = 0; i < unit.size(); ++i)
+	{
+		params[i] = m_lower[i] + unit[i] * (m_upper[i] - m_lower[i]);
+	}
+	return params;
+}
+
+void BayesOpt::AddObservation(const std::vector<double>& params, const double error)
+{
+	if (m_errors.empty() || error < m_bestError)
+	{
+		m_bestError = error;
+		m_bestParams = params;
+	}
+	m_points.push_back(normalize(params));
+	m_errors.push_back(error);
+}
+
+std::vector<std::vector<double>> BayesOpt::SuggestBatch()
+{
+	const size_t dims = m_lower.size();
+	std::uniform_real_distribution<double> uniform(0.0, 1.0);
+	std::normal_distribution<double> local(0.0, LOCAL_SPREAD);
+
+	std::vector<std::vector<double>> batch;
+
+	// Not enough data for a useful model yet: sample uniformly
+	if (m_errors.size() < dims + 1u)
+	{
+		for (unsigned b = 0u; b < m_batchSize; ++b)
+		{
+			std::vector<double> unit(dims);
+			for (double& u : unit) u = uniform(m_rng);
+			batch.push_back(denormalize(unit));
+		}
+		return batch;
+	}
+
+	// Pending points of the batch pretend to have the best error seen so far ("constant liar"),
+	// which pushes later suggestions of the same batch away from them.
+	std::vector<std::vector<double>> points = m_points;
+	std::vector<double> errors = m_errors;
+	const std::vector<double> bestUnit = normalize(m_bestParams);
+
+	for (unsigned b = 0u; b < m_batchSize; ++b)
+	{
+		const GaussianProcess gp(points, errors, LENGTH_SCALE, NOISE_VARIANCE);
+		const double best = gp.Standardize(m_bestError);
+
+		std::vector<double> bestCandidate;
+		double bestScore = -1.0;
+		for (unsigned c = 0u; c < RANDOM_CANDIDATES + LOCAL_CANDIDATES; ++c)
+		{
+			std::vector<double> candidate(dims);
+			for (size_t i = 0; i < dims; ++i)
+			{
+				candidate[i] = c < RANDOM_CANDIDATES ? uniform(m_rng)
+				                                     : std::min(std::max(bestUnit[i] + local(m_rng), 0.0), 1.0);
+			}
+
+			double mean, stddev;
+			gp.Predict(candidate, mean, stddev);
+			const double score = ExpectedImprovement(best, mean, stddev, EXPLORATION);
+			if (score > bestScore)
+			{
+				bestScore = score;
+				bestCandidate = candidate;
+			}
+		}
+
+		points.push_back(bestCandidate);
+		errors.push_back(m_bestError);
+		batch.push_back(denormalize(bestCandidate));
+	}
+	return batch;
+}
+
+bool BayesOpt::runOnce(const double error, std::vector<double>& params)
+{
+	AddObservation(params, error);
+
+	if (m_errors.size() >= m_budget)
+	{
+		params = m_bestParams;
+		return true;  // Completed
+	}
+
+	if (m_pending.empty())
+	{
+		for (auto& suggestion : SuggestBatch())
+		{
+			m_pending.push_back(suggestion);
+		}
+	}
+
+	params = m_pending.front();
+	m_pending.pop_front();
+	return false;  // Not completed yet
+}
@@ -0,0 +1,65 @@
+#ifndef BAYES_OPT_H
+#define BAYES_OPT_H
+
+
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "Tuner.h"
+
+namespace pid_control
+{
+	class BayesOpt : public Tuner
+	{
+	public:
+		/*
+		* Bayesian optimization of the parameters within a box.
+		* A Gaussian process with a squared exponential kernel models the error over the (normalized)
+		* parameter space, and the next parameters are the ones maximizing the expected improvement.
+		* Suggestions are made in batches of `batchSize`, using the "constant liar" heuristic for pending
+		* points, so a batch can be evaluated in parallel.
+		* Completes after `budget` evaluations.
+		*/
+		BayesOpt(const std::vector<double>& lower, const std::vector<double>& upper,
+		         unsigned budget, unsigned batchSize, unsigned seed);
+
+		bool runOnce(const double error, std::vector<double>& params) override;
+
+		/*
+		* The next `batchSize` parameters to evaluate, without recording an error.
+		* runOnce uses it internally; exposed for callers that evaluate a batch in parallel.
+		*/
+		std::vector<std::vector<double>> SuggestBatch();
+
+		/*
+		* Record the error of parameters evaluated outside of runOnce.
+		*/
+		void AddObservation(const std::vector<double>& params, const double error);
+
+		std::vector<double> GetBestParams() const override { return m_bestParams; };
+		double GetBestError() const { return m_bestError; };
+		unsigned GetEvaluations() const { return static_cast<unsigned>(m_errors.size()); };
+
+	private:
+		std::vector<double> normalize(const std::vector<double>& params) const;
+		std::vector<double> denormalize(const std::vector<double>& unit) const;
+
+		const std::vector<double> m_lower;
+		const std::vector<double> m_upper;
+		const unsigned m_budget { 0u };
+		const unsigned m_batchSize { 1u };
+
+		std::mt19937 m_rng;
+
+		std::vector<std::vector<double>> m_points;  // Evaluated parameters, normalized to [0, 1]
+		std::vector<double> m_errors;
+
+		std::deque<std::vector<double>> m_pending;  // Suggested but not yet evaluated, denormalized
+
+		double m_bestError { 0.0 };
+		std::vector<double> m_bestParams;
+	};
+}
+
+#endif  // BAYES_OPT_H
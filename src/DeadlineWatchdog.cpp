@@ -0,0 +1,60 @@
+#include "DeadlineWatchdog.h"
+
+#include <string>
+
+#include "spdlog/fmt/fmt.h"
+
+
+using namespace pid_control;
+
+
+static uint64_t nanosBetween(DeadlineWatchdog::Clock::time_point from, DeadlineWatchdog::Clock::time_point to)
+{
+    const auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+    return nanos > 0 ? static_cast<uint64_t>(nanos) : 0u;
+}
+
+DeadlineWatchdog::DeadlineWatchdog(uint64_t budgetNanos) :
+    m_budgetNanos(budgetNanos)
+{}
+
+bool DeadlineWatchdog::Expired(Clock::time_point arrival, Clock::time_point now) const
+{
+    return Enabled() && nanosBetween(arrival, now) > m_budgetNanos;
+}
+
+bool DeadlineWatchdog::Finish(Clock::time_point arrival, Clock::time_point sent)
+{
+    if (not Enabled())
+    {
+        return false;
+    }
+
+    m_ticks++;
+    m_windowTicks++;
+
+    const uint64_t elapsed = nanosBetween(arrival, sent);
+    if (elapsed <= m_budgetNanos)
+    {
+        return false;
+    }
+
+    m_misses++;
+    m_windowMisses++;
+    m_overrun.Record(elapsed - m_budgetNanos);
+    return true;
+}
+
+std::string DeadlineWatchdog::Summary() const
+{
+    return fmt::format("budget={:.1f}us missed {}/{} ticks (total {}/{}, fallbacks {}), overrun: {}",
+                       m_budgetNanos / 1e3, m_windowMisses, m_windowTicks, m_misses, m_ticks, m_fallbacks,
+                       m_overrun.Summary());
+}
+
+void DeadlineWatchdog::ResetWindow()
+{
+    m_windowTicks = 0u;
+    m_windowMisses = 0u;
+    m_overrun.Reset();
+}
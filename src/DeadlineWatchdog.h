@@ -0,0 +1,64 @@
+#ifndef DEADLINE_WATCHDOG_H
+#define DEADLINE_WATCHDOG_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "LatencyHistogram.h"
+
+
+namespace pid_control
+{
+    /*
+    * Tracks whether each steering reply is sent within a time budget of the telemetry arrival it answers.
+    * A budget of 0 disables the watchdog.
+    */
+    class DeadlineWatchdog
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        explicit DeadlineWatchdog(uint64_t budgetNanos);
+
+        bool Enabled() const { return m_budgetNanos > 0u; };
+
+        /*
+        * True if the budget for the telemetry that arrived at `arrival` is already used up.
+        * Used to skip the control computation and fall back to the previous command.
+        */
+        bool Expired(Clock::time_point arrival, Clock::time_point now) const;
+
+        /*
+        * Records the reply to telemetry that arrived at `arrival` as sent at `sent`.
+        * Returns true if the deadline was missed.
+        */
+        bool Finish(Clock::time_point arrival, Clock::time_point sent);
+
+        void CountFallback() { m_fallbacks++; };
+
+        uint64_t Ticks() const { return m_ticks; };
+        uint64_t Misses() const { return m_misses; };
+        uint64_t Fallbacks() const { return m_fallbacks; };
+        uint64_t WindowTicks() const { return m_windowTicks; };
+
+        /*
+        * One-line summary of misses since the last ResetWindow(), plus lifetime totals.
+        */
+        std::string Summary() const;
+        void ResetWindow();
+
+    private:
+        const uint64_t m_budgetNanos { 0u };
+
+        uint64_t m_ticks { 0u };
+        uint64_t m_misses { 0u };
+        uint64_t m_fallbacks { 0u };
+
+        uint64_t m_windowTicks { 0u };
+        uint64_t m_windowMisses { 0u };
+        LatencyHistogram m_overrun;  // How far past the deadline the missed replies were sent
+    };
+}
+
+#endif  // DEADLINE_WATCHDOG_H
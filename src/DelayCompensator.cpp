@@ -0,0 +1,73 @@
+#include "DelayCompensator.h"
+
+#include <algorithm>
+
+
+using namespace pid_control;
+
+
+constexpr unsigned DelayCompensator::HISTORY;
+
+static double secondsBetween(DelayCompensator::Clock::time_point from, DelayCompensator::Clock::time_point to)
+{
+    return std::chrono::duration<double>(to - from).count();
+}
+
+DelayCompensator::DelayCompensator(double modelGain, double smoothing) :
+    m_modelGain(modelGain), m_smoothing(smoothing)
+{}
+
+void DelayCompensator::Reset()
+{
+    m_delay = 0.0;
+    m_awaitingTelemetry = false;
+    m_next = 0u;
+    m_count = 0u;
+}
+
+void DelayCompensator::OnTelemetry(Clock::time_point arrival)
+{
+    if (not m_awaitingTelemetry)
+    {
+        return;
+    }
+    m_awaitingTelemetry = false;
+
+    const Command& last = m_commands[(m_next + HISTORY - 1u) % HISTORY];
+    const double sample = secondsBetween(last.sent, arrival);
+    m_delay = m_count == 1u ? sample : m_delay + m_smoothing * (sample - m_delay);
+}
+
+void DelayCompensator::OnCommand(Clock::time_point sent, double steering)
+{
+    m_commands[m_next] = {sent, steering};
+    m_next = (m_next + 1u) % HISTORY;
+    m_count = std::min(m_count + 1u, HISTORY);
+    m_awaitingTelemetry = true;
+}
+
+double DelayCompensator::Predict(double cte, double speed, Clock::time_point arrival) const
+{
+    // Each command acts from its send time until the next one was sent (the newest one until `arrival`).
+    // Only the part of that interval inside the last `m_delay` seconds is not yet visible in the CTE.
+    const auto windowStart = arrival - std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(m_delay));
+
+    double unseen = 0.0;
+    Clock::time_point end = arrival;
+    for (unsigned i = 1u; i <= m_count; ++i)
+    {
+        const Command& command = m_commands[(m_next + HISTORY - i) % HISTORY];
+        const Clock::time_point start = std::max(command.sent, windowStart);
+        if (start < end)
+        {
+            unseen += command.steering * secondsBetween(start, end);
+        }
+        if (command.sent <= windowStart)
+        {
+            break;
+        }
+        end = command.sent;
+    }
+
+    return cte + m_modelGain * speed * unseen;
+}
@@ -0,0 +1,75 @@
+#ifndef DELAY_COMPENSATOR_H
+#define DELAY_COMPENSATOR_H
+
+#include <array>
+#include <chrono>
+
+
+namespace pid_control
+{
+    /*
+    * Smith-predictor style compensation of actuation latency.
+    *
+    * The simulator applies a steering command some time after the telemetry it was computed from,
+    * so the CTE the controller sees does not yet reflect the commands that are still in flight.
+    * The compensator measures that delay per connection (time from sending a command to receiving
+    * the next telemetry) and adds the effect of the in-flight commands to the measured CTE using
+    * a simple integrator model of the plant:
+    *     d(cte)/dt = modelGain * speed * steering
+    * The PID is then applied to the predicted CTE instead of the measured one.
+    */
+    class DelayCompensator
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /*
+        * modelGain - CTE change per second, per unit of speed and unit of steering.
+        * smoothing - weight of a new delay sample in the running average, in (0, 1].
+        */
+        DelayCompensator(double modelGain, double smoothing);
+
+        /*
+        * Forget the measured delay and the in-flight commands, e.g. on a new connection.
+        */
+        void Reset();
+
+        /*
+        * Called on telemetry arrival; takes a round-trip delay sample against the last sent command.
+        */
+        void OnTelemetry(Clock::time_point arrival);
+
+        /*
+        * Called when a steering command is sent.
+        */
+        void OnCommand(Clock::time_point sent, double steering);
+
+        /*
+        * CTE predicted `DelaySeconds()` ahead of the telemetry that arrived at `arrival`.
+        */
+        double Predict(double cte, double speed, Clock::time_point arrival) const;
+
+        double DelaySeconds() const { return m_delay; };
+
+    private:
+        struct Command
+        {
+            Clock::time_point sent;
+            double steering;
+        };
+
+        static constexpr unsigned HISTORY = 16u;
+
+        const double m_modelGain { 0.0 };
+        const double m_smoothing { 1.0 };
+
+        double m_delay { 0.0 };
+        bool m_awaitingTelemetry { false };
+
+        std::array<Command, HISTORY> m_commands {};
+        unsigned m_next { 0u };   // Ring buffer write position
+        unsigned m_count { 0u };
+    };
+}
+
+#endif  // DELAY_COMPENSATOR_H
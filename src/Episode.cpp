@@ -0,0 +1,59 @@
+#include "Episode.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+using namespace pid_control;
+
+
+// Steering angle of full steering, in degrees, as the simulator reports it
+static constexpr double MAX_STEERING_ANGLE = 25.0;
+
+double EpisodeResult::Error(const EpisodeLimits& limits) const
+{
+    return std::numeric_limits<unsigned>::max() - ticks + std::min(meanAbsCte / limits.maxCte, 0.99);
+}
+
+EpisodeResult pid_control::RunEpisode(VehicleSim& sim, PID& pid, double throttle, const EpisodeLimits& limits,
+                                      const std::function<void(const VehicleSim&)>& onTick,
+                                      const GainSchedule* schedule)
+{
+    EpisodeResult result;
+    double cteSum = 0.0;
+    double steering = 0.0;
+
+    while (result.ticks < limits.maxTicks)
+    {
+        // Scored and ended on the true CTE. Like the control loop, which only has the telemetry,
+        // the minimum speed check and the controller see the measurements.
+        const double cte = sim.TrueCte();
+        const double speed = sim.SpeedMph();
+        const bool errorTooLarge = std::abs(cte) > limits.maxCte;
+        const bool gotTooSlow = speed < limits.minSpeed;
+        if (result.ticks >= limits.graceTicks && (errorTooLarge || gotTooSlow))
+        {
+            result.failed = true;
+            break;
+        }
+
+        if (schedule)
+        {
+            const auto gains = schedule->Lookup(speed, std::abs(steering) * MAX_STEERING_ANGLE);
+            pid.UpdateParams(gains[0], gains[1], gains[2]);
+        }
+        steering = pid.Apply(sim.Cte());
+        sim.Step(steering, throttle);
+        cteSum += std::abs(cte);
+        result.ticks++;
+
+        if (onTick)
+        {
+            onTick(sim);
+        }
+    }
+
+    result.meanAbsCte = result.ticks > 0u ? cteSum / result.ticks : 0.0;
+    return result;
+}
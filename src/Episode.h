@@ -0,0 +1,47 @@
+#ifndef EPISODE_H
+#define EPISODE_H
+
+#include <functional>
+
+#include "GainSchedule.h"
+#include "PID.h"
+#include "VehicleSim.h"
+
+
+namespace pid_control
+{
+    /*
+    * When a headless tuning episode ends; the same rules the control loop applies to the real simulator.
+    */
+    struct EpisodeLimits
+    {
+        unsigned graceTicks { 100u };   // No early termination in the first ticks
+        double maxCte { 2.5 };
+        double minSpeed { 5.0 };        // mph
+        unsigned maxTicks { 4000u };
+    };
+
+    struct EpisodeResult
+    {
+        unsigned ticks { 0u };
+        double meanAbsCte { 0.0 };
+        bool failed { false };
+
+        /*
+        * Error handed to the tuners: shorter runs are worse, and the mean CTE, scaled below one tick,
+        * breaks ties between runs of the same length.
+        */
+        double Error(const EpisodeLimits& limits) const;
+    };
+
+    /*
+    * Drives `sim` from its current state with `pid` at constant throttle until the episode ends.
+    * `onTick`, if set, is called after every step.
+    * With a `schedule`, the PID's gains are looked up in it every tick, from the measured speed and the steering angle.
+    */
+    EpisodeResult RunEpisode(VehicleSim& sim, PID& pid, double throttle, const EpisodeLimits& limits,
+                             const std::function<void(const VehicleSim&)>& onTick = nullptr,
+                             const GainSchedule* schedule = nullptr);
+}
+
+#endif  // EPISODE_H
@@ -0,0 +1,30 @@
+#ifndef FAST_JSON_H
+#define FAST_JSON_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// json.hpp 2.1.1's parser assigns discarded values, whose json_value GCC 12 cannot see initialized
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include "json.hpp"
+#pragma GCC diagnostic pop
+
+#include "Arena.h"
+
+
+namespace pid_control
+{
+    /*
+    * nlohmann::json with its objects, arrays and string values allocated from the current thread's Arena,
+    * for parsing telemetry without touching the heap. Values must not outlive the arena's next Reset().
+    * Strings stay std::string (json.hpp 2.1.1 mixes string_t with std::string in its parser); the short
+    * telemetry keys and values fit its small string buffer.
+    */
+    using fast_json = nlohmann::basic_json<std::map, std::vector, std::string, bool, std::int64_t, std::uint64_t, double,
+                                           ArenaAllocator>;
+}
+
+#endif  // FAST_JSON_H
@@ -0,0 +1,58 @@
+#include "GainSchedule.h"
+
+#include <algorithm>
+#include <vector>
+
+
+using namespace pid_control;
+
+
+static double nodesPerUnit(unsigned nodes, double max)
+{
+    return nodes > 1u && max > 0.0 ? (nodes - 1u) / max : 0.0;
+}
+
+GainSchedule::GainSchedule(unsigned speedNodes, double maxSpeed, unsigned curvatureNodes, double maxCurvature,
+                           const Gains& initial) :
+    m_speed({std::max(speedNodes, 1u), nodesPerUnit(speedNodes, maxSpeed)}),
+    m_curvature({std::max(curvatureNodes, 1u), nodesPerUnit(curvatureNodes, maxCurvature)})
+{
+    const unsigned nodes = m_speed.nodes * m_curvature.nodes;
+    m_params.reserve(nodes * initial.size());
+    for (unsigned i = 0u; i < nodes; ++i)
+    {
+        m_params.insert(m_params.end(), initial.begin(), initial.end());
+    }
+}
+
+void GainSchedule::locate(const Axis& axis, double value, unsigned& lower, unsigned& upper, double& weight)
+{
+    // min/max compile to minsd/maxsd, and the integer min to a conditional move.
+    // std::max(0.0, x) returns 0.0 for a NaN x (e.g. "nan" telemetry), which keeps the node index in range
+    const double position = std::min(std::max(0.0, value * axis.nodesPerUnit), static_cast<double>(axis.nodes - 1u));
+    lower = static_cast<unsigned>(position);
+    upper = std::min(lower + 1u, axis.nodes - 1u);
+    weight = position - lower;
+}
+
+GainSchedule::Gains GainSchedule::Lookup(double speed, double curvature) const
+{
+    unsigned s0, s1, c0, c1;
+    double sw, cw;
+    locate(m_speed, speed, s0, s1, sw);
+    locate(m_curvature, curvature, c0, c1, cw);
+
+    const double* p00 = &m_params[3u * (c0 * m_speed.nodes + s0)];
+    const double* p01 = &m_params[3u * (c0 * m_speed.nodes + s1)];
+    const double* p10 = &m_params[3u * (c1 * m_speed.nodes + s0)];
+    const double* p11 = &m_params[3u * (c1 * m_speed.nodes + s1)];
+
+    Gains gains;
+    for (unsigned i = 0u; i < 3u; ++i)
+    {
+        const double low = p00[i] + sw * (p01[i] - p00[i]);
+        const double high = p10[i] + sw * (p11[i] - p10[i]);
+        gains[i] = low + cw * (high - low);
+    }
+    return gains;
+}
@@ -0,0 +1,54 @@
+#ifndef GAIN_SCHEDULE_H
+#define GAIN_SCHEDULE_H
+
+#include <array>
+#include <vector>
+
+
+namespace pid_control
+{
+    /*
+    * PID gains scheduled over a uniform grid of speed and, optionally, curvature.
+    * Gains between grid nodes are bilinearly interpolated; lookups outside the grid clamp to its edges.
+    * The lookup has no data dependent branches, so it costs the same every tick.
+    */
+    class GainSchedule
+    {
+    public:
+        using Gains = std::array<double, 3>;
+
+        /*
+        * speedNodes and curvatureNodes are the number of grid nodes on each axis, spread evenly over
+        * [0, maxSpeed] and [0, maxCurvature]. A single node disables interpolation along that axis.
+        * Every node starts with `initial` gains.
+        */
+        GainSchedule(unsigned speedNodes, double maxSpeed, unsigned curvatureNodes, double maxCurvature,
+                     const Gains& initial);
+
+        Gains Lookup(double speed, double curvature) const;
+
+        /*
+        * All node gains flattened as {kp, ki, kd} per node, so the schedule can be tuned like a single PID.
+        */
+        std::vector<double> GetParams() const { return m_params; };
+        void UpdateParams(const std::vector<double>& params) { m_params = params; };
+
+    private:
+        struct Axis
+        {
+            unsigned nodes;
+            double nodesPerUnit;
+        };
+
+        /*
+        * Lower node index, upper node index and the weight of the upper node for a value on the axis.
+        */
+        static void locate(const Axis& axis, double value, unsigned& lower, unsigned& upper, double& weight);
+
+        const Axis m_speed;
+        const Axis m_curvature;
+        std::vector<double> m_params;
+    };
+}
+
+#endif  // GAIN_SCHEDULE_H
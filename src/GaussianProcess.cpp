@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "GaussianProcess.h"
+
+using namespace pid_control;
+
+
+GaussianProcess::GaussianProcess(const std::vector<std::vector<double>>& points, const std::vector<double>& values,
+                                 const double lengthScale, const double noiseVariance) :
+	m_points(points), m_lengthScale(lengthScale)
+{
+	const size_t n = values.size();
+
+	double mean = 0.0;
+	for (double v : values) mean += v;
+	mean /= n;
+	double variance = 0.0;
+	for (double v : values) variance += (v - mean) * (v - mean);
+	variance /= n;
+	m_mean = mean;
+	m_scale = variance > 0.0 ? std::sqrt(variance) : 1.0;
+
+	// Cholesky factorization of K + noise * I
+	m_chol.resize(n);
+	for (auto& row : m_chol)
+	{
+		row.resize(n, 0.0);
+	}
+	for (size_t i = 0; i < n; ++i)
+	{
+		for (size_t j = 0; j <= i; ++j)
+		{
+			double sum = kernel(points[i], points[j]) + (i == j ? noiseVariance : 0.0);
+			for (size_t k = 0; k < j; ++k)
+			{
+				sum -= m_chol[i][k] * m_chol[j][k];
+			}
+			m_chol[i][j] = i == j ? std::sqrt(std::max(sum, 1e-12)) : sum / m_chol[j][j];
+		}
+	}
+
+	// alpha = K^-1 y
+	std::vector<double> y(n);
+	for (size_t i = 0; i < n; ++i)
+	{
+		y[i] = Standardize(values[i]);
+	}
+	m_alpha = solveUpper(solveLower(y));
+}
+
+void GaussianProcess::Predict(const std::vector<double>& x, double& mean, double& stddev) const
+{
+	const size_t n = m_points.size();
+	std::vector<double> k(n);
+	mean = 0.0;
+	for (size_t i = 0; i < n; ++i)
+	{
+		k[i] = kernel(x, m_points[i]);
+		mean += k[i] * m_alpha[i];
+	}
+	const std::vector<double> v = solveLower(k);
+	double variance = 1.0;
+	for (double vi : v) variance -= vi * vi;
+	stddev = std::sqrt(std::max(variance, 1e-12));
+}
+
+double GaussianProcess::kernel(const std::vector<double>& a, const std::vector<double>& b) const
+{
+	double distance = 0.0;
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		distance += (a[i] - b[i]) * (a[i] - b[i]);
+	}
+	return std::exp(-0.5 * distance / (m_lengthScale * m_lengthScale));
+}
+
+std::vector<double> GaussianProcess::solveLower(const std::vector<double>& b) const
+{
+	std::vector<double> x(b);
+	for (size_t i = 0; i < x.size(); ++i)
+	{
+		for (size_t k = 0; k < i; ++k)
+		{
+			x[i] -= m_chol[i][k] * x[k];
+		}
+		x[i] /= m_chol[i][i];
+	}
+	return x;
+}
+
+std::vector<double> GaussianProcess::solveUpper(const std::vector<double>& b) const
+{
+	std::vector<double> x(b);
+	for (size_t i = x.size(); i-- > 0;)
+	{
+		for (size_t k = i + 1; k < x.size(); ++k)
+		{
+			x[i] -= m_chol[k][i] * x[k];
+		}
+		x[i] /= m_chol[i][i];
+	}
+	return x;
+}
+
+double pid_control::ExpectedImprovement(const double best, const double mean, const double stddev,
+                                        const double exploration)
+{
+	const double improvement = best - mean - exploration;
+	const double z = improvement / stddev;
+	const double cdf = 0.5 * std::erfc(-z / std::sqrt(2.0));
+	const double pdf = std::exp(-0.5 * z * z) / std::sqrt(2.0 * M_PI);
+	return improvement * cdf + stddev * pdf;
+}
@@ -0,0 +1,52 @@
+#ifndef GAUSSIAN_PROCESS_H
+#define GAUSSIAN_PROCESS_H
+
+
+#include <vector>
+
+namespace pid_control
+{
+	class GaussianProcess
+	{
+	public:
+		/*
+		* Gaussian process regression with a squared exponential kernel of `lengthScale` over `points`,
+		* on the `values` standardized to zero mean and unit variance, with observation noise `noiseVariance`
+		* (in standardized units).
+		*/
+		GaussianProcess(const std::vector<std::vector<double>>& points, const std::vector<double>& values,
+		                const double lengthScale, const double noiseVariance);
+
+		/*
+		* Posterior mean and standard deviation at `x`, in standardized units.
+		*/
+		void Predict(const std::vector<double>& x, double& mean, double& stddev) const;
+
+		double Standardize(const double value) const { return (value - m_mean) / m_scale; }
+
+		/*
+		* Lower triangular L with L L' = K + noise * I.
+		*/
+		const std::vector<std::vector<double>>& GetCholesky() const { return m_chol; }
+
+	private:
+		double kernel(const std::vector<double>& a, const std::vector<double>& b) const;
+		std::vector<double> solveLower(const std::vector<double>& b) const;
+		std::vector<double> solveUpper(const std::vector<double>& b) const;
+
+		const std::vector<std::vector<double>> m_points;
+		const double m_lengthScale { 1.0 };
+		std::vector<std::vector<double>> m_chol;
+		std::vector<double> m_alpha;  // (K + noise * I)^-1 y
+		double m_mean { 0.0 };
+		double m_scale { 1.0 };
+	};
+
+	/*
+	* Expected improvement over `best` by more than `exploration`, of a point whose value (to be minimized)
+	* is normally distributed with `mean` and `stddev`.
+	*/
+	double ExpectedImprovement(const double best, const double mean, const double stddev, const double exploration);
+}
+
+#endif  // GAUSSIAN_PROCESS_H
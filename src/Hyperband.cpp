@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "Hyperband.h"
+
+using namespace pid_control;
+
+
+static unsigned maxBracket(const unsigned minTicks, const unsigned maxTicks, const unsigned eta)
+{
+	unsigned brackets = 0u;
+	for (double ticks = maxTicks; ticks / eta >= minTicks; ticks /= eta)
+	{
+		brackets++;
+	}
+	// Without a halving round, the only bracket would hold a single candidate
+	return std::max(brackets, 1u);
+}
+
+static unsigned power(const unsigned base, const unsigned exponent)
+{
+	unsigned result = 1u;
+	for (unsigned i = 0u; i < exponent; ++i)
+	{
+		result *= base;
+	}
+	return result;
+}
+
+Hyperband::Hyperband(const std::vector<double>& lower, const std::vector<double>& upper,
+                     const unsigned minTicks, const unsigned maxTicks, const unsigned eta, const unsigned seed) :
+	m_lower(lower), m_upper(upper), m_maxTicks(maxTicks), m_eta(std::max(eta, 2u)),
+	m_maxBracket(maxBracket(std::max(minTicks, 1u), maxTicks, std::max(eta, 2u))), m_rng(seed),
+	m_bracket(m_maxBracket), m_bestError(std::numeric_limits<double>::max())
+{
+	m_rungTicks = m_maxTicks / power(m_eta, m_bracket);
+}
+
+std::vector<double> Hyperband::sample()
+{
+	std::vector<double> params(m_lower.size());
+	for (size_t i = 0; i < params.size(); ++i)
+	{
+		std::uniform_real_distribution<double> uniform(m_lower[i], m_upper[i]);
+		params[i] = uniform(m_rng);
+	}
+	return params;
+}
+
+void Hyperband::startBracket(const std::vector<double>* first)
+{
+	// n = ceil((s_max + 1) / (s + 1) * eta^s) candidates, each starting with maxTicks * eta^-s ticks
+	const unsigned s = m_bracket;
+	const unsigned count = static_cast<unsigned>(std::ceil(static_cast<double>(m_maxBracket + 1u) / (s + 1u) * power(m_eta, s)));
+
+	m_candidates.clear();
+	for (unsigned i = 0u; i < count; ++i)
+	{
+		m_candidates.push_back({i == 0u && first ? *first : sample(), 0.0});
+	}
+	m_rung = 0u;
+	m_rungTicks = m_maxTicks / power(m_eta, s);
+	m_current = 0u;
+}
+
+unsigned Hyperband::GetEpisodeTicks(const unsigned maxTicks) const
+{
+	return std::min(m_rungTicks, maxTicks);
+}
+
+bool Hyperband::runOnce(const double error, std::vector<double>& params)
+{
+	// The parameters the caller started with become the first candidate of the first bracket
+	if (not m_started)
+	{
+		m_started = true;
+		startBracket(&params);
+	}
+
+	m_candidates[m_current].error = error;
+	if (m_rungTicks >= m_maxTicks && error < m_bestError)
+	{
+		m_bestError = error;
+		m_bestParams = m_candidates[m_current].params;
+	}
+
+	if (++m_current >= m_candidates.size())
+	{
+		// Rung complete: promote the best 1/eta, or move on to the next bracket
+		const size_t survivors = m_candidates.size() / m_eta;
+		if (m_rung < m_bracket && survivors > 0u)
+		{
+			std::stable_sort(m_candidates.begin(), m_candidates.end(),
+			                 [](const Candidate& a, const Candidate& b) { return a.error < b.error; });
+			m_candidates.resize(survivors);
+			m_rung++;
+			// From maxTicks rather than eta times the previous rung, which rounding would leave short of a full episode
+			m_rungTicks = m_maxTicks / power(m_eta, m_bracket - m_rung);
+			m_current = 0u;
+		}
+		else if (m_bracket > 0u)
+		{
+			m_bracket--;
+			startBracket(nullptr);
+		}
+		else
+		{
+			if (not m_bestParams.empty())
+			{
+				params = m_bestParams;
+			}
+			return true;  // Completed
+		}
+	}
+
+	params = m_candidates[m_current].params;
+	return false;  // Not completed yet
+}
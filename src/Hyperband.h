@@ -0,0 +1,68 @@
+#ifndef HYPERBAND_H
+#define HYPERBAND_H
+
+
+#include <random>
+#include <vector>
+
+#include "Tuner.h"
+
+namespace pid_control
+{
+	class Hyperband : public Tuner
+	{
+	public:
+		/*
+		* Hyperband: successive halving over random parameters within a box, in brackets trading off
+		* the number of candidates against their initial episode length.
+		* Within a bracket, every candidate of a rung runs an episode of the rung's length, and only the best
+		* 1/eta of them are promoted to the next rung, whose episodes are eta times longer, up to `maxTicks`.
+		* Completes after the last bracket, with the best candidate that ran a full length episode.
+		* There is at least one halving round, even when its first rung has to be shorter than `minTicks`.
+		*/
+		Hyperband(const std::vector<double>& lower, const std::vector<double>& upper,
+		          const unsigned minTicks, const unsigned maxTicks, const unsigned eta, const unsigned seed);
+
+		bool runOnce(const double error, std::vector<double>& params) override;
+
+		unsigned GetEpisodeTicks(const unsigned maxTicks) const override;
+
+		/*
+		* Only candidates that ran a full length episode qualify.
+		*/
+		std::vector<double> GetBestParams() const override { return m_bestParams; };
+
+	private:
+		struct Candidate
+		{
+			std::vector<double> params;
+			double error;
+		};
+
+		/*
+		* Creates the candidates of the current bracket. The first one is `first` if given.
+		*/
+		void startBracket(const std::vector<double>* first);
+		std::vector<double> sample();
+
+		const std::vector<double> m_lower;
+		const std::vector<double> m_upper;
+		const unsigned m_maxTicks { 0u };
+		const unsigned m_eta { 3u };
+		const unsigned m_maxBracket { 0u };
+
+		std::mt19937 m_rng;
+
+		unsigned m_bracket { 0u };    // Counts down from m_maxBracket to 0
+		unsigned m_rung { 0u };
+		unsigned m_rungTicks { 0u };
+		std::vector<Candidate> m_candidates;
+		size_t m_current { 0u };      // Candidate being evaluated
+		bool m_started { false };
+
+		double m_bestError { 0.0 };
+		std::vector<double> m_bestParams;
+	};
+}
+
+#endif  // HYPERBAND_H
@@ -0,0 +1,76 @@
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <string>
+
+#include "spdlog/fmt/fmt.h"
+
+
+using namespace pid_control;
+
+
+constexpr unsigned LatencyHistogram::SUB_BUCKETS;
+constexpr unsigned LatencyHistogram::BUCKETS;
+
+unsigned LatencyHistogram::bucketOf(uint64_t nanos)
+{
+    if (nanos < SUB_BUCKETS)
+    {
+        return static_cast<unsigned>(nanos);
+    }
+    // Index of the highest set bit, then the next two bits select the sub-bucket
+    const unsigned log2 = 63u - static_cast<unsigned>(__builtin_clzll(nanos));
+    const unsigned sub = static_cast<unsigned>(nanos >> (log2 - 2u)) & (SUB_BUCKETS - 1u);
+    return std::min((log2 - 1u) * SUB_BUCKETS + sub, BUCKETS - 1u);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(unsigned bucket)
+{
+    if (bucket < SUB_BUCKETS)
+    {
+        return bucket;
+    }
+    const unsigned log2 = bucket / SUB_BUCKETS + 1u;
+    const uint64_t sub = bucket % SUB_BUCKETS;
+    return ((SUB_BUCKETS + sub + 1u) << (log2 - 2u)) - 1u;
+}
+
+void LatencyHistogram::Record(uint64_t nanos)
+{
+    m_buckets[bucketOf(nanos)]++;
+    m_count++;
+    m_sum += nanos;
+    m_min = std::min(m_min, nanos);
+    m_max = std::max(m_max, nanos);
+}
+
+void LatencyHistogram::Reset()
+{
+    *this = LatencyHistogram();
+}
+
+uint64_t LatencyHistogram::Percentile(double percentile) const
+{
+    if (m_count == 0u)
+    {
+        return 0u;
+    }
+    const uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * (m_count - 1u)) + 1u;
+    uint64_t seen = 0u;
+    for (unsigned i = 0u; i < BUCKETS; ++i)
+    {
+        seen += m_buckets[i];
+        if (seen >= rank)
+        {
+            return std::min(bucketUpperBound(i), m_max);
+        }
+    }
+    return m_max;
+}
+
+std::string LatencyHistogram::Summary() const
+{
+    return fmt::format("n={} min={:.1f}us mean={:.1f}us p50={:.1f}us p99={:.1f}us p99.9={:.1f}us max={:.1f}us",
+                       m_count, Min() / 1e3, Mean() / 1e3, Percentile(50.0) / 1e3,
+                       Percentile(99.0) / 1e3, Percentile(99.9) / 1e3, Max() / 1e3);
+}
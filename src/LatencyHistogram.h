@@ -0,0 +1,52 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+
+namespace pid_control
+{
+    /*
+    * Fixed-size histogram of durations in nanoseconds.
+    * Buckets are powers of two split into 4 linear sub-buckets, so percentiles are accurate to ~25%.
+    * Recording never allocates, so it is safe to use from the control thread.
+    */
+    class LatencyHistogram
+    {
+    public:
+        void Record(uint64_t nanos);
+        void Reset();
+
+        uint64_t Count() const { return m_count; };
+        uint64_t Min() const { return m_count ? m_min : 0; };
+        uint64_t Max() const { return m_max; };
+        double Mean() const { return m_count ? static_cast<double>(m_sum) / m_count : 0.0; };
+
+        /*
+        * Upper bound of the bucket holding the given percentile, in [0, 100].
+        */
+        uint64_t Percentile(double percentile) const;
+
+        /*
+        * One-line human readable summary in microseconds.
+        */
+        std::string Summary() const;
+
+    private:
+        static constexpr unsigned SUB_BUCKETS = 4u;
+        static constexpr unsigned BUCKETS = 64u * SUB_BUCKETS;
+
+        static unsigned bucketOf(uint64_t nanos);
+        static uint64_t bucketUpperBound(unsigned bucket);
+
+        std::array<uint64_t, BUCKETS> m_buckets {};
+        uint64_t m_count { 0u };
+        uint64_t m_sum { 0u };
+        uint64_t m_min { UINT64_MAX };
+        uint64_t m_max { 0u };
+    };
+}
+
+#endif  // LATENCY_HISTOGRAM_H
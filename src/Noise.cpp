@@ -0,0 +1,35 @@
+#include "Noise.h"
+
+#include <cmath>
+
+
+using namespace pid_control;
+
+
+// splitmix64 finalizer
+static uint64_t mix(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+static uint64_t hash(uint64_t seed, NoiseStream stream, uint64_t index)
+{
+    return mix(mix(mix(seed) ^ static_cast<uint64_t>(stream)) ^ index);
+}
+
+double pid_control::NoiseUniform(uint64_t seed, NoiseStream stream, uint64_t index)
+{
+    // Top 53 bits as a double in [0, 1)
+    return (hash(seed, stream, index) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+double pid_control::NoiseGaussian(uint64_t seed, NoiseStream stream, uint64_t index)
+{
+    // Box-Muller on two uniforms of the same index
+    const double u1 = 1.0 - NoiseUniform(seed, stream, 2u * index);
+    const double u2 = NoiseUniform(seed, stream, 2u * index + 1u);
+    return std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * M_PI * u2);
+}
@@ -0,0 +1,46 @@
+#ifndef NOISE_H
+#define NOISE_H
+
+#include <cstdint>
+
+
+namespace pid_control
+{
+    /*
+    * Disturbances the headless simulator can inject, for robustness (Monte Carlo) evaluation.
+    */
+    struct NoiseConfig
+    {
+        double cteStddev { 0.0 };           // Measurement noise on the CTE the controller sees, m
+        double speedStddev { 0.0 };         // Measurement noise on the speed, mph
+        unsigned maxDelayTicks { 0u };      // Actuation delay, drawn per episode from [0, maxDelayTicks]
+        double dynamicsSpread { 0.0 };      // Steering response and drag scaled per episode by [1 - spread, 1 + spread]
+
+        bool Enabled() const
+        {
+            return cteStddev > 0.0 || speedStddev > 0.0 || maxDelayTicks > 0u || dynamicsSpread > 0.0;
+        }
+    };
+
+    /*
+    * Independent random streams, one per kind of disturbance.
+    */
+    enum class NoiseStream : uint64_t
+    {
+        CTE = 1u,
+        SPEED = 2u,
+        DELAY = 3u,
+        STEERING = 4u,
+        DRAG = 5u,
+    };
+
+    /*
+    * Counter-based random numbers: the value is a hash of (seed, stream, index), with no generator state.
+    * Noise at a given tick therefore only depends on the episode seed and the tick, so restoring a snapshot
+    * replays the same noise, and draws in one stream never shift another.
+    */
+    double NoiseUniform(uint64_t seed, NoiseStream stream, uint64_t index);   // [0, 1)
+    double NoiseGaussian(uint64_t seed, NoiseStream stream, uint64_t index);  // Standard normal
+}
+
+#endif  // NOISE_H
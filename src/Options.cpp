@@ -0,0 +1,333 @@
+#include "Options.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "spdlog/spdlog.h"
+
+
+using namespace pid_control;
+using std::string;
+
+
+static bool parseUnsigned(const string& value, unsigned& out)
+{
+    // strtoul would accept (and negate) a sign and surrounding white space
+    if (value.empty() || not std::isdigit(static_cast<unsigned char>(value[0])))
+    {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long parsed = std::strtoul(value.c_str(), &end, 10);
+    if (*end != '\0' || errno == ERANGE || parsed > UINT_MAX)
+    {
+        return false;
+    }
+    out = static_cast<unsigned>(parsed);
+    return true;
+}
+
+static bool parseInt(const string& value, int& out)
+{
+    if (value.empty() || std::isspace(static_cast<unsigned char>(value[0])))
+    {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    const long parsed = std::strtol(value.c_str(), &end, 10);
+    if (*end != '\0' || errno == ERANGE || parsed < INT_MIN || parsed > INT_MAX)
+    {
+        return false;
+    }
+    out = static_cast<int>(parsed);
+    return true;
+}
+
+static bool parseDouble(const string& value, double& out)
+{
+    if (value.empty() || std::isspace(static_cast<unsigned char>(value[0])))
+    {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    const double parsed = std::strtod(value.c_str(), &end);
+    if (*end != '\0' || errno == ERANGE || not std::isfinite(parsed))
+    {
+        return false;
+    }
+    out = parsed;
+    return true;
+}
+
+/*
+* Parses "kp,ki,kd".
+*/
+static bool parseParams(const string& value, std::vector<double>& out)
+{
+    std::vector<double> params;
+    for (size_t begin = 0u; begin <= value.size(); )
+    {
+        const size_t end = std::min(value.find(',', begin), value.size());
+        double param = 0.0;
+        if (not parseDouble(value.substr(begin, end - begin), param))
+        {
+            return false;
+        }
+        params.push_back(param);
+        begin = end + 1u;
+    }
+    if (params.size() != 3u)
+    {
+        return false;
+    }
+    out = params;
+    return true;
+}
+
+bool pid_control::ParseOptions(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const string arg = argv[i];
+        const auto eq = arg.find('=');
+        const string name = arg.substr(0, eq);
+        const string value = eq == string::npos ? "" : arg.substr(eq + 1);
+
+        bool ok = true;
+        if (name == "--realtime")
+        {
+            options.realTime = true;
+        }
+        else if (name == "--cpu")
+        {
+            ok = parseInt(value, options.cpu) && options.cpu >= 0;
+        }
+        else if (name == "--rt-priority")
+        {
+            ok = parseInt(value, options.rtPriority) && options.rtPriority >= 1 && options.rtPriority <= 99;
+        }
+        else if (name == "--prefault-mb")
+        {
+            ok = parseUnsigned(value, options.prefaultMb);
+        }
+        else if (name == "--jitter-report")
+        {
+            ok = parseUnsigned(value, options.jitterReportTicks);
+        }
+        else if (name == "--async-log")
+        {
+            options.asyncLog = true;
+        }
+        else if (name == "--log-file")
+        {
+            options.logFile = value;
+            ok = not value.empty();
+        }
+        else if (name == "--log-file-mb")
+        {
+            ok = parseUnsigned(value, options.logFileMb) && options.logFileMb > 0u;
+        }
+        else if (name == "--log-files")
+        {
+            ok = parseUnsigned(value, options.logFiles);
+        }
+        else if (name == "--log-rate")
+        {
+            ok = parseDouble(value, options.logRate) && options.logRate >= 0.0;
+        }
+        else if (name == "--log-sample")
+        {
+            ok = parseUnsigned(value, options.logSample) && options.logSample > 0u;
+        }
+        else if (name == "--trace")
+        {
+            options.tracePath = value;
+            ok = not value.empty();
+        }
+        else if (name == "--protocols")
+        {
+            options.protocols = value;
+        }
+        else if (name == "--transport")
+        {
+            options.transport = value;
+        }
+        else if (name == "--port")
+        {
+            ok = parseUnsigned(value, options.port) && options.port > 0u && options.port < 65536u;
+        }
+        else if (name == "--unix-socket")
+        {
+            // Implies the transport
+            options.socketPath = value;
+            options.transport = "unix";
+            ok = not value.empty();
+        }
+        else if (name == "--shm")
+        {
+            // Implies the transport
+            options.shmName = value;
+            options.transport = "shm";
+            ok = not value.empty();
+        }
+        else if (name == "--deadline-us")
+        {
+            ok = parseUnsigned(value, options.deadlineUs);
+        }
+        else if (name == "--deadline-fallback")
+        {
+            options.deadlineFallback = true;
+        }
+        else if (name == "--deadline-report")
+        {
+            ok = parseUnsigned(value, options.deadlineReportTicks);
+        }
+        else if (name == "--throttle")
+        {
+            ok = parseDouble(value, options.throttle);
+        }
+        else if (name == "--init-params")
+        {
+            ok = parseParams(value, options.initParams);
+        }
+        else if (name == "--latency-comp")
+        {
+            options.latencyCompensation = true;
+        }
+        else if (name == "--latency-gain")
+        {
+            ok = parseDouble(value, options.latencyModelGain);
+        }
+        else if (name == "--nominal-tick-ms")
+        {
+            ok = parseDouble(value, options.nominalTickMs) && options.nominalTickMs >= 0.0;
+        }
+        else if (name == "--schedule-speed-nodes")
+        {
+            ok = parseUnsigned(value, options.scheduleSpeedNodes);
+        }
+        else if (name == "--schedule-max-speed")
+        {
+            ok = parseDouble(value, options.scheduleMaxSpeed) && options.scheduleMaxSpeed > 0.0;
+        }
+        else if (name == "--schedule-curvature-nodes")
+        {
+            ok = parseUnsigned(value, options.scheduleCurvatureNodes) && options.scheduleCurvatureNodes > 0u;
+        }
+        else if (name == "--adaptive")
+        {
+            options.adaptive = true;
+        }
+        else if (name == "--adaptive-pole")
+        {
+            ok = parseDouble(value, options.adaptivePole) && options.adaptivePole > 0.0 && options.adaptivePole < 1.0;
+        }
+        else if (name == "--adaptive-dither")
+        {
+            ok = parseDouble(value, options.adaptiveDither) && options.adaptiveDither >= 0.0;
+        }
+        else if (name == "--tuner")
+        {
+            options.tuner = value;
+            ok = value == "twiddle" || value == "bayes" || value == "hyperband";
+        }
+        else if (name == "--tuner-budget")
+        {
+            ok = parseUnsigned(value, options.tunerBudget) && options.tunerBudget > 0u;
+        }
+        else if (name == "--bayes-batch")
+        {
+            ok = parseUnsigned(value, options.bayesBatch) && options.bayesBatch > 0u;
+        }
+        else if (name == "--hyperband-min-ticks")
+        {
+            ok = parseUnsigned(value, options.hyperbandMinTicks) && options.hyperbandMinTicks > 0u;
+        }
+        else if (name == "--seed")
+        {
+            ok = parseUnsigned(value, options.seed);
+        }
+        else if (name == "--relay-autotune")
+        {
+            options.relayAutoTune = true;
+        }
+        else if (name == "--relay-amplitude")
+        {
+            ok = parseDouble(value, options.relayAmplitude) && options.relayAmplitude > 0.0;
+        }
+        else if (name == "--fork")
+        {
+            options.fork = true;
+        }
+        else if (name == "--fork-ticks")
+        {
+            ok = parseUnsigned(value, options.forkTicks) && options.forkTicks > 0u;
+        }
+        else if (name == "--checkpoints")
+        {
+            ok = parseUnsigned(value, options.checkpoints) && options.checkpoints > 0u;
+        }
+        else if (name == "--fork-rounds")
+        {
+            ok = parseUnsigned(value, options.forkRounds) && options.forkRounds > 0u;
+        }
+        else if (name == "--bench-cars")
+        {
+            ok = parseUnsigned(value, options.benchCars);
+        }
+        else if (name == "--tracks")
+        {
+            ok = parseUnsigned(value, options.tracks) && options.tracks > 0u;
+        }
+        else if (name == "--cte-noise")
+        {
+            ok = parseDouble(value, options.noise.cteStddev) && options.noise.cteStddev >= 0.0;
+        }
+        else if (name == "--speed-noise")
+        {
+            ok = parseDouble(value, options.noise.speedStddev) && options.noise.speedStddev >= 0.0;
+        }
+        else if (name == "--max-delay-ticks")
+        {
+            ok = parseUnsigned(value, options.noise.maxDelayTicks);
+        }
+        else if (name == "--dynamics-spread")
+        {
+            ok = parseDouble(value, options.noise.dynamicsSpread) && options.noise.dynamicsSpread >= 0.0
+                 && options.noise.dynamicsSpread < 1.0;
+        }
+        else if (name == "--mc-seeds")
+        {
+            ok = parseUnsigned(value, options.mcSeeds) && options.mcSeeds > 0u;
+        }
+        else if (name == "--mc-worst")
+        {
+            options.mcWorstCase = true;
+        }
+        else if (name == "--independent-seeds")
+        {
+            options.commonRandomNumbers = false;
+        }
+        else
+        {
+            spdlog::error("Unknown option: {}", arg);
+            return false;
+        }
+
+        if (not ok)
+        {
+            spdlog::error("Malformed value for option: {}", arg);
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,184 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <string>
+#include <vector>
+
+#include "Noise.h"
+
+
+namespace pid_control
+{
+    /*
+    * Startup options of the pid binary, parsed from the command line.
+    */
+    struct Options
+    {
+        /*
+        * Real-time execution mode: pin the control thread, request SCHED_FIFO,
+        * lock and pre-fault memory.
+        */
+        bool realTime { false };
+        int cpu { 0 };
+        int rtPriority { 80 };
+        unsigned prefaultMb { 64u };
+
+        /*
+        * How many ticks to accumulate before logging a jitter report. 0 disables the report.
+        */
+        unsigned jitterReportTicks { 1000u };
+
+        /*
+        * Log through a background thread, so the control loop only enqueues messages.
+        * When the queue is full, messages are dropped rather than blocking the control loop.
+        */
+        bool asyncLog { false };
+
+        /*
+        * Also log to this file, rotated every `logFileMb` megabytes. The last `logFiles` closed segments are kept,
+        * gzip compressed on a background thread. Empty logs to the console only.
+        */
+        std::string logFile;
+        unsigned logFileMb { 64u };
+        unsigned logFiles { 5u };
+
+        /*
+        * Throttle messages logged per call site (the per-tick SPDLOG_* macros): keep only one in `logSample`
+        * of them, and at most `logRate` per second. Suppressed counts are summarized periodically.
+        * A rate of 0 does not limit the rate.
+        */
+        double logRate { 0.0 };
+        unsigned logSample { 1u };
+
+        /*
+        * File to write a binary per-tick trace to, decoded offline with pid_trace_decode. Empty disables tracing.
+        */
+        std::string tracePath;
+
+        /*
+        * How to exchange telemetry and commands with the simulator:
+        *   "websocket" - the simulator's socket.io on `port`
+        *   "unix"      - STRUCT frames over the Unix domain socket `socketPath`
+        *   "shm"       - the shared memory segment `shmName` (an shm_open name), for simulators linking pid_shm
+        *   "io_uring"  - STRUCT frames over TCP on `port`, served with io_uring (when built with liburing)
+        */
+        std::string transport { "websocket" };
+        unsigned port { 4567u };
+        std::string socketPath { "/tmp/pid.sock" };
+        std::string shmName { "pid" };
+
+        /*
+        * Comma separated binary protocols ("struct", "msgpack") a WebSocket client may switch the connection to
+        * with a "hello" event. Empty keeps every connection on the socket.io text protocol.
+        */
+        std::string protocols { "struct,msgpack" };
+
+        /*
+        * Time budget in microseconds from telemetry arrival to the steering reply. 0 disables the watchdog.
+        * With the fallback enabled, telemetry that is already past its deadline is answered with
+        * the previous steering command instead of running the controller.
+        * Misses are reported every `deadlineReportTicks` ticks; 0 disables the report.
+        */
+        unsigned deadlineUs { 0u };
+        bool deadlineFallback { false };
+        unsigned deadlineReportTicks { 1000u };
+
+        double throttle { 0.3 };
+
+        /*
+        * Initial {kp, ki, kd}, which tuning starts from. Empty starts from zero gains, except in adaptive mode,
+        * which then finds initial gains with the relay auto-tune.
+        */
+        std::vector<double> initParams;
+
+        /*
+        * Compensate actuation latency by predicting the CTE forward by the measured round-trip delay.
+        */
+        bool latencyCompensation { false };
+        double latencyModelGain { 0.01 };
+
+        /*
+        * Length of a nominal tick in milliseconds. When set, the PID is driven by the measured time
+        * between telemetry arrivals in units of nominal ticks, so gains tuned at a fixed tick rate still apply
+        * when telemetry is decimated, coalesced or sped up. 0 keeps the fixed-tick controller.
+        */
+        double nominalTickMs { 0.0 };
+
+        /*
+        * Gain schedule: number of speed nodes over [0, scheduleMaxSpeed] mph, and of curvature nodes over
+        * the absolute steering angle (a proxy for path curvature). 0 speed nodes uses a single set of gains.
+        * Twiddle tunes every node of the schedule.
+        */
+        unsigned scheduleSpeedNodes { 0u };
+        double scheduleMaxSpeed { 100.0 };
+        unsigned scheduleCurvatureNodes { 1u };
+
+        /*
+        * Online adaptive tuning: identify a local plant model with recursive least squares while driving
+        * and move the PD gains towards the ones placing the closed loop poles at `adaptivePole`.
+        * Replaces Twiddle: the simulator is only reset, and the gains restored to the initial ones,
+        * when the car leaves the track.
+        */
+        bool adaptive { false };
+        double adaptivePole { 0.9 };
+        double adaptiveDither { 0.02 };
+
+        /*
+        * Episode tuner: "twiddle", "bayes" (Bayesian optimization with a Gaussian process surrogate)
+        * or "hyperband" (successive halving of episode lengths).
+        * The budget and batch size apply to Bayesian optimization, the minimum episode length to Hyperband.
+        */
+        std::string tuner { "twiddle" };
+        unsigned tunerBudget { 60u };
+        unsigned bayesBatch { 4u };
+        unsigned hyperbandMinTicks { 150u };
+        unsigned seed { 1u };
+
+        /*
+        * Find initial gains with a relay feedback experiment (Åström–Hägglund) before tuning,
+        * steering by +-relayAmplitude.
+        */
+        bool relayAutoTune { false };
+        double relayAmplitude { 0.3 };
+
+        /*
+        * Headless tuning (pid_tune): evaluate candidates by forking short episodes from `checkpoints` snapshots of
+        * the hardest parts of a reference run with the best gains so far, instead of full runs from the track start.
+        * The reference run is refreshed with the tuned gains `forkRounds` times.
+        */
+        bool fork { false };
+        unsigned forkTicks { 400u };
+        unsigned checkpoints { 8u };
+        unsigned forkRounds { 1u };
+
+        /*
+        * pid_tune: only measure the throughput of stepping this many cars in lockstep.
+        */
+        unsigned benchCars { 0u };
+
+        /*
+        * pid_tune: score every candidate on this many procedurally generated tracks (seeded from `seed`),
+        * evaluated in parallel. 1 uses the built-in track.
+        */
+        unsigned tracks { 1u };
+
+        /*
+        * pid_tune: sensor noise, actuation delay and dynamics randomization injected into the headless simulator.
+        * With any of them enabled, every candidate is scored over `mcSeeds` randomized episodes per track,
+        * by the mean cost, or by the worst case with `mcWorstCase`.
+        * With common random numbers, all candidates share the same seeds; otherwise each evaluation draws new ones.
+        */
+        NoiseConfig noise;
+        unsigned mcSeeds { 16u };
+        bool mcWorstCase { false };
+        bool commonRandomNumbers { true };
+    };
+
+    /*
+    * Parses "--name" and "--name=value" arguments into options.
+    * Returns false (after logging the reason) on an unknown or malformed argument, or a value out of range.
+    */
+    bool ParseOptions(int argc, char* argv[], Options& options);
+}
+
+#endif  // OPTIONS_H
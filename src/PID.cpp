@@ -13,8 +13,18 @@ PID::PID(double kp, double ki, double kd) :
 
 double PID::Apply(double cte)
 {
-    m_totalError += cte;
-    double value = - m_kp * cte - m_ki * m_totalError - m_kd * (cte - m_prevError);
+    return Apply(cte, 1.0);
+}
+
+double PID::Apply(double cte, double dt)
+{
+    double derivative = 0.0;
+    if (dt > 0.0)
+    {
+        m_totalError += cte * dt;
+        derivative = (cte - m_prevError) / dt;
+    }
+    double value = - m_kp * cte - m_ki * m_totalError - m_kd * derivative;
     m_prevError = cte;
 
     // Clamp to [-1.0, 1.0]
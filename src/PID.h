@@ -20,7 +20,24 @@ namespace pid_control
         };
         inline void UpdateParams(std::vector<double> pidParams) { UpdateParams(pidParams[0], pidParams[1], pidParams[2]); };
 
+        /*
+        * Forget the accumulated error, e.g. when taking over a car mid-run. `cte` becomes the previous error.
+        */
+        inline void Reset(double cte = 0.0)
+        {
+            m_totalError = 0.0;
+            m_prevError = cte;
+        };
+
         double Apply(double cte);
+
+        /*
+        * Apply the controller to an error sampled `dt` after the previous one.
+        * The integral accumulates cte * dt and the derivative is the error slope over dt,
+        * so gains keep their meaning when ticks are unevenly spaced. Apply(cte) is Apply(cte, 1.0).
+        * A non-positive dt only applies the proportional and accumulated integral terms.
+        */
+        double Apply(double cte, double dt);
         std::vector<double> GetParams() { return {m_kp, m_ki, m_kd}; };
 
     private:
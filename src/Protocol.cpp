@@ -0,0 +1,430 @@
+#include "Protocol.h"
+
+#include <cstring>
+
+
+using namespace pid_control;
+
+
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "The STRUCT protocol is encoded with the host byte order, which must be little endian"
+#endif
+
+// MessagePack markers
+static constexpr uint8_t MSGPACK_POSITIVE_FIXINT_MAX = 0x7fu;
+static constexpr uint8_t MSGPACK_FIXMAP = 0x80u;
+static constexpr uint8_t MSGPACK_FIXARRAY_2 = 0x92u;
+static constexpr uint8_t MSGPACK_FIXSTR = 0xa0u;
+static constexpr uint8_t MSGPACK_NIL = 0xc0u;
+static constexpr uint8_t MSGPACK_FALSE = 0xc2u;
+static constexpr uint8_t MSGPACK_TRUE = 0xc3u;
+static constexpr uint8_t MSGPACK_FLOAT32 = 0xcau;
+static constexpr uint8_t MSGPACK_FLOAT64 = 0xcbu;
+static constexpr uint8_t MSGPACK_UINT8 = 0xccu;
+static constexpr uint8_t MSGPACK_UINT16 = 0xcdu;
+static constexpr uint8_t MSGPACK_UINT32 = 0xceu;
+static constexpr uint8_t MSGPACK_UINT64 = 0xcfu;
+static constexpr uint8_t MSGPACK_INT8 = 0xd0u;
+static constexpr uint8_t MSGPACK_INT16 = 0xd1u;
+static constexpr uint8_t MSGPACK_INT32 = 0xd2u;
+static constexpr uint8_t MSGPACK_INT64 = 0xd3u;
+static constexpr uint8_t MSGPACK_STR8 = 0xd9u;
+static constexpr uint8_t MSGPACK_STR16 = 0xdau;
+static constexpr uint8_t MSGPACK_STR32 = 0xdbu;
+static constexpr uint8_t MSGPACK_MAP16 = 0xdeu;
+static constexpr uint8_t MSGPACK_NEGATIVE_FIXINT_MIN = 0xe0u;
+
+const char* pid_control::ProtocolName(WireProtocol protocol)
+{
+    switch (protocol)
+    {
+    case WireProtocol::MSGPACK: return "msgpack";
+    case WireProtocol::STRUCT: return "struct";
+    default: return "text";
+    }
+}
+
+bool pid_control::ParseProtocolName(const std::string& name, WireProtocol& protocol)
+{
+    for (const auto candidate : {WireProtocol::TEXT, WireProtocol::MSGPACK, WireProtocol::STRUCT})
+    {
+        if (name == ProtocolName(candidate))
+        {
+            protocol = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+* Reads a frame's MessagePack in place. Every read fails, without moving past the end, on truncated or
+* unexpected input.
+*/
+class MsgpackReader
+{
+public:
+    MsgpackReader(const char* data, size_t length) :
+        m_cursor(reinterpret_cast<const uint8_t*>(data)), m_end(m_cursor + length)
+    {
+    }
+
+    bool AtEnd() const { return m_cursor == m_end; };
+
+    bool ReadByte(uint8_t& byte)
+    {
+        if (m_cursor == m_end)
+        {
+            return false;
+        }
+        byte = *m_cursor++;
+        return true;
+    }
+
+    // A fixmap or map 16 header
+    bool ReadMapSize(size_t& size)
+    {
+        uint8_t marker = 0u;
+        if (not ReadByte(marker))
+        {
+            return false;
+        }
+        if ((marker & 0xf0u) == MSGPACK_FIXMAP)
+        {
+            size = marker & 0x0fu;
+            return true;
+        }
+        return marker == MSGPACK_MAP16 && readBigEndian(2u, size);
+    }
+
+    // A fixstr or str 8, pointing into the frame
+    bool ReadString(const char*& text, size_t& length)
+    {
+        uint8_t marker = 0u;
+        if (not ReadByte(marker))
+        {
+            return false;
+        }
+        if ((marker & 0xe0u) == MSGPACK_FIXSTR)
+        {
+            length = marker & 0x1fu;
+        }
+        else if (marker != MSGPACK_STR8 || not readBigEndian(1u, length))
+        {
+            return false;
+        }
+        text = reinterpret_cast<const char*>(m_cursor);
+        return skip(length);
+    }
+
+    // Any number, which senders may encode as an integer when it has no fraction
+    bool ReadNumber(double& value)
+    {
+        uint8_t marker = 0u;
+        uint64_t bits = 0u;
+        if (not ReadByte(marker))
+        {
+            return false;
+        }
+        switch (marker)
+        {
+        case MSGPACK_FLOAT64:
+            if (not readBigEndian(8u, bits))
+            {
+                return false;
+            }
+            std::memcpy(&value, &bits, sizeof(value));
+            return true;
+        case MSGPACK_FLOAT32:
+        {
+            float single = 0.0f;
+            uint32_t singleBits = 0u;
+            if (not readBigEndian(4u, singleBits))
+            {
+                return false;
+            }
+            std::memcpy(&single, &singleBits, sizeof(single));
+            value = single;
+            return true;
+        }
+        case MSGPACK_UINT8: case MSGPACK_UINT16: case MSGPACK_UINT32: case MSGPACK_UINT64:
+            if (not readBigEndian(1u << (marker - MSGPACK_UINT8), bits))
+            {
+                return false;
+            }
+            value = static_cast<double>(bits);
+            return true;
+        case MSGPACK_INT8: case MSGPACK_INT16: case MSGPACK_INT32: case MSGPACK_INT64:
+        {
+            const unsigned bytes = 1u << (marker - MSGPACK_INT8);
+            if (not readBigEndian(bytes, bits))
+            {
+                return false;
+            }
+            // Sign extend
+            const unsigned unused = 64u - 8u * bytes;
+            value = static_cast<double>(static_cast<int64_t>(bits << unused) >> unused);
+            return true;
+        }
+        default:
+            if (marker <= MSGPACK_POSITIVE_FIXINT_MAX || marker >= MSGPACK_NEGATIVE_FIXINT_MIN)
+            {
+                value = static_cast<int8_t>(marker);
+                return true;
+            }
+            return false;
+        }
+    }
+
+    // The value of a field pid does not use: anything but a container
+    bool SkipScalar()
+    {
+        const uint8_t* start = m_cursor;
+        const char* text = nullptr;
+        size_t length = 0u;
+        double value = 0.0;
+        if (ReadString(text, length))
+        {
+            return true;
+        }
+        m_cursor = start;
+        if (ReadNumber(value))
+        {
+            return true;
+        }
+        m_cursor = start;
+        if (skipLongString())
+        {
+            return true;
+        }
+        m_cursor = start;
+        uint8_t marker = 0u;
+        return ReadByte(marker) && (marker == MSGPACK_NIL || marker == MSGPACK_FALSE || marker == MSGPACK_TRUE);
+    }
+
+private:
+    bool skip(size_t bytes)
+    {
+        if (static_cast<size_t>(m_end - m_cursor) < bytes)
+        {
+            return false;
+        }
+        m_cursor += bytes;
+        return true;
+    }
+
+    template<typename Unsigned>
+    bool readBigEndian(unsigned bytes, Unsigned& value)
+    {
+        if (static_cast<size_t>(m_end - m_cursor) < bytes)
+        {
+            return false;
+        }
+        uint64_t bits = 0u;
+        for (unsigned i = 0u; i < bytes; ++i)
+        {
+            bits = (bits << 8u) | *m_cursor++;
+        }
+        value = static_cast<Unsigned>(bits);
+        return true;
+    }
+
+    // A str 16 or str 32, e.g. a camera image
+    bool skipLongString()
+    {
+        uint8_t marker = 0u;
+        size_t length = 0u;
+        if (not ReadByte(marker))
+        {
+            return false;
+        }
+        const unsigned bytes = marker == MSGPACK_STR16 ? 2u : marker == MSGPACK_STR32 ? 4u : 0u;
+        return bytes > 0u && readBigEndian(bytes, length) && skip(length);
+    }
+
+    const uint8_t* m_cursor;
+    const uint8_t* m_end;
+};
+
+static bool isKey(const char* text, size_t length, const char* key)
+{
+    return length == std::strlen(key) && std::memcmp(text, key, length) == 0;
+}
+
+/*
+* ["telemetry", {"cte": x, "speed": x, "steering_angle": x, "throttle": x}], with the fields in any order and
+* throttle optional. Other fields are skipped when they are not containers.
+*/
+static bool decodeMsgpack(const char* data, size_t length, Telemetry& telemetry)
+{
+    MsgpackReader reader(data, length);
+    uint8_t marker = 0u;
+    const char* name = nullptr;
+    size_t nameLength = 0u;
+    size_t fields = 0u;
+    if (not reader.ReadByte(marker) || marker != MSGPACK_FIXARRAY_2 || not reader.ReadString(name, nameLength) ||
+        not isKey(name, nameLength, "telemetry") || not reader.ReadMapSize(fields))
+    {
+        return false;
+    }
+
+    enum : unsigned { CTE = 1u, SPEED = 2u, STEERING_ANGLE = 4u };
+    unsigned found = 0u;
+    telemetry.throttle = 0.0;
+    for (size_t i = 0u; i < fields; ++i)
+    {
+        const char* key = nullptr;
+        size_t keyLength = 0u;
+        if (not reader.ReadString(key, keyLength))
+        {
+            return false;
+        }
+
+        bool read = false;
+        if (isKey(key, keyLength, "cte"))
+        {
+            read = reader.ReadNumber(telemetry.cte);
+            found |= CTE;
+        }
+        else if (isKey(key, keyLength, "speed"))
+        {
+            read = reader.ReadNumber(telemetry.speed);
+            found |= SPEED;
+        }
+        else if (isKey(key, keyLength, "steering_angle"))
+        {
+            read = reader.ReadNumber(telemetry.steeringAngle);
+            found |= STEERING_ANGLE;
+        }
+        else if (isKey(key, keyLength, "throttle"))
+        {
+            read = reader.ReadNumber(telemetry.throttle);
+        }
+        else
+        {
+            read = reader.SkipScalar();
+        }
+        if (not read)
+        {
+            return false;
+        }
+    }
+    return found == (CTE | SPEED | STEERING_ANGLE) && reader.AtEnd();
+}
+
+static bool decodeStruct(const char* data, size_t length, Telemetry& telemetry)
+{
+    if (length != STRUCT_TELEMETRY_BYTES || static_cast<uint8_t>(data[0]) != static_cast<uint8_t>(StructFrameType::TELEMETRY))
+    {
+        return false;
+    }
+    double values[4];
+    std::memcpy(values, data + STRUCT_HEADER_BYTES, sizeof(values));
+    telemetry.cte = values[0];
+    telemetry.speed = values[1];
+    telemetry.steeringAngle = values[2];
+    telemetry.throttle = values[3];
+    return true;
+}
+
+bool pid_control::DecodeTelemetry(WireProtocol protocol, const char* data, size_t length, Telemetry& telemetry)
+{
+    switch (protocol)
+    {
+    case WireProtocol::MSGPACK: return decodeMsgpack(data, length, telemetry);
+    case WireProtocol::STRUCT: return decodeStruct(data, length, telemetry);
+    default: return false;
+    }
+}
+
+static void appendByte(fmt::memory_buffer& out, uint8_t byte)
+{
+    out.push_back(static_cast<char>(byte));
+}
+
+static void appendMsgpackString(fmt::memory_buffer& out, const char* text)
+{
+    const size_t length = std::strlen(text);
+    appendByte(out, static_cast<uint8_t>(MSGPACK_FIXSTR | length));
+    out.append(text, text + length);
+}
+
+static void appendMsgpackDouble(fmt::memory_buffer& out, double value)
+{
+    uint64_t bits = 0u;
+    std::memcpy(&bits, &value, sizeof(bits));
+    appendByte(out, MSGPACK_FLOAT64);
+    for (int shift = 56; shift >= 0; shift -= 8)
+    {
+        appendByte(out, static_cast<uint8_t>(bits >> shift));  // Big endian
+    }
+}
+
+static void appendStruct(fmt::memory_buffer& out, StructFrameType type, const double* values, size_t count)
+{
+    char header[STRUCT_HEADER_BYTES] = {static_cast<char>(type)};
+    out.append(header, header + sizeof(header));
+    const char* bytes = reinterpret_cast<const char*>(values);
+    out.append(bytes, bytes + count * sizeof(double));
+}
+
+void pid_control::EncodeSteer(WireProtocol protocol, double steering, double throttle, fmt::memory_buffer& out)
+{
+    switch (protocol)
+    {
+    case WireProtocol::MSGPACK:
+        // ["steer", {"steering_angle": steering, "throttle": throttle}], as to_msgpack would write it
+        appendByte(out, MSGPACK_FIXARRAY_2);
+        appendMsgpackString(out, "steer");
+        appendByte(out, MSGPACK_FIXMAP | 2u);
+        appendMsgpackString(out, "steering_angle");
+        appendMsgpackDouble(out, steering);
+        appendMsgpackString(out, "throttle");
+        appendMsgpackDouble(out, throttle);
+        break;
+    case WireProtocol::STRUCT:
+    {
+        const double values[] = {steering, throttle};
+        appendStruct(out, StructFrameType::STEER, values, 2u);
+        break;
+    }
+    default:
+        fmt::format_to(out, "42[\"steer\",{{\"steering_angle\":{},\"throttle\":{}}}]", steering, throttle);
+        break;
+    }
+}
+
+void pid_control::EncodeReset(WireProtocol protocol, fmt::memory_buffer& out)
+{
+    switch (protocol)
+    {
+    case WireProtocol::MSGPACK:
+        appendByte(out, MSGPACK_FIXARRAY_2);
+        appendMsgpackString(out, "reset");
+        appendByte(out, MSGPACK_FIXMAP);
+        break;
+    case WireProtocol::STRUCT:
+        appendStruct(out, StructFrameType::RESET, nullptr, 0u);
+        break;
+    default:
+        fmt::format_to(out, "42[\"reset\",{{}}]");
+        break;
+    }
+}
+
+bool StructStreamReader::Next(Telemetry& telemetry, bool& malformed)
+{
+    malformed = false;
+    if (m_end - m_begin < STRUCT_TELEMETRY_BYTES)
+    {
+        // Move the partial frame to the front, so there is room for the rest of it
+        std::memmove(m_buffer.data(), m_buffer.data() + m_begin, m_end - m_begin);
+        m_end -= m_begin;
+        m_begin = 0u;
+        return false;
+    }
+
+    malformed = not decodeStruct(m_buffer.data() + m_begin, STRUCT_TELEMETRY_BYTES, telemetry);
+    m_begin += STRUCT_TELEMETRY_BYTES;
+    return not malformed;
+}
@@ -0,0 +1,78 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "spdlog/fmt/fmt.h"
+
+#include "Telemetry.h"
+
+
+namespace pid_control
+{
+    /*
+    * Wire formats of telemetry and commands. TEXT is the simulator's socket.io JSON. A client may offer
+    * the binary ones with a hello event, after which both directions use binary WebSocket frames:
+    *   MSGPACK - MessagePack of the same [event, data] array, with numbers instead of numeric strings
+    *   STRUCT  - fixed layout, little endian: uint8 type, 7 padding bytes, then the values as doubles
+    *             (telemetry: cte, speed, steering angle, throttle; steer: steering angle, throttle; reset: none)
+    */
+    enum class WireProtocol
+    {
+        TEXT,
+        MSGPACK,
+        STRUCT,
+    };
+
+    // STRUCT frames: the header holds the type and the padding that aligns the values
+    static constexpr size_t STRUCT_HEADER_BYTES = 8u;
+    static constexpr size_t STRUCT_TELEMETRY_BYTES = STRUCT_HEADER_BYTES + 4u * sizeof(double);
+
+    enum class StructFrameType : uint8_t
+    {
+        TELEMETRY = 1u,
+        STEER = 2u,
+        RESET = 3u,
+    };
+
+    const char* ProtocolName(WireProtocol protocol);
+    bool ParseProtocolName(const std::string& name, WireProtocol& protocol);
+
+    /*
+    * Decodes a binary telemetry frame in place, without allocating.
+    * Returns false for frames that are not telemetry or are malformed.
+    */
+    bool DecodeTelemetry(WireProtocol protocol, const char* data, size_t length, Telemetry& telemetry);
+
+    /*
+    * Append a steer or reset command in the given format to `out`.
+    */
+    void EncodeSteer(WireProtocol protocol, double steering, double throttle, fmt::memory_buffer& out);
+    void EncodeReset(WireProtocol protocol, fmt::memory_buffer& out);
+
+    /*
+    * Splits a byte stream (a Unix or TCP socket) into STRUCT telemetry frames.
+    * Receive into WriteSpace() bytes at WritePointer(), Commit() what was received, then call Next() until it
+    * returns false. `malformed` is set when the stream does not hold telemetry frames, after which it cannot be resynced.
+    */
+    class StructStreamReader
+    {
+    public:
+        char* WritePointer() { return m_buffer.data() + m_end; };
+        size_t WriteSpace() const { return m_buffer.size() - m_end; };
+        void Commit(size_t bytes) { m_end += bytes; };
+        void Reset() { m_begin = m_end = 0u; };
+
+        bool Next(Telemetry& telemetry, bool& malformed);
+
+    private:
+        std::array<char, 64u * STRUCT_TELEMETRY_BYTES> m_buffer;
+        size_t m_begin { 0u };
+        size_t m_end { 0u };
+    };
+}
+
+#endif  // PROTOCOL_H
@@ -0,0 +1,95 @@
+#include "RealTime.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+#include "spdlog/spdlog.h"
+
+
+using namespace pid_control;
+
+
+// Enough for the deepest call chain of the telemetry handler, with plenty of margin
+static constexpr size_t PREFAULT_STACK_BYTES = 512u * 1024u;
+
+static void __attribute__((noinline)) prefaultStack()
+{
+    unsigned char stack[PREFAULT_STACK_BYTES];
+    std::memset(stack, 0, sizeof(stack));
+    // Keep the compiler from eliding the writes
+    asm volatile("" : : "r"(stack) : "memory");
+}
+
+static bool prefaultHeap(size_t bytes)
+{
+    // Keep freed memory in the malloc arena and never serve allocations with fresh mmaps,
+    // so the pages touched here are the ones reused by the control loop.
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+
+    if (bytes == 0u)
+    {
+        return true;
+    }
+    char* block = static_cast<char*>(std::malloc(bytes));
+    if (block == nullptr)
+    {
+        return false;
+    }
+    for (size_t i = 0u; i < bytes; i += 4096u)
+    {
+        block[i] = 0;
+    }
+    std::free(block);
+    return true;
+}
+
+bool pid_control::EnableRealTime(int cpu, int priority, size_t prefaultBytes)
+{
+    bool ok = true;
+
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (rc != 0)
+    {
+        spdlog::error("Failed to pin control thread to CPU {}: {}", cpu, std::strerror(rc));
+        ok = false;
+    }
+
+    sched_param param {};
+    param.sched_priority = priority;
+    rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (rc != 0)
+    {
+        spdlog::error("Failed to set SCHED_FIFO priority {}: {}", priority, std::strerror(rc));
+        ok = false;
+    }
+
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+    {
+        spdlog::error("Failed to lock memory: {}", std::strerror(errno));
+        ok = false;
+    }
+
+    if (not prefaultHeap(prefaultBytes))
+    {
+        spdlog::error("Failed to pre-fault {} bytes of heap", prefaultBytes);
+        ok = false;
+    }
+    prefaultStack();
+
+    if (ok)
+    {
+        spdlog::info("Real-time mode: CPU {}, SCHED_FIFO priority {}, {} MB pre-faulted",
+                     cpu, priority, prefaultBytes / (1024u * 1024u));
+    }
+    return ok;
+}
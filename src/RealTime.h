@@ -0,0 +1,22 @@
+#ifndef REAL_TIME_H
+#define REAL_TIME_H
+
+#include <cstddef>
+
+
+namespace pid_control
+{
+    /*
+    * Moves the calling thread into a real-time friendly configuration:
+    * - pins it to the given CPU,
+    * - requests SCHED_FIFO with the given priority,
+    * - locks all current and future pages in RAM,
+    * - stops malloc from returning memory to the OS and pre-faults `prefaultBytes` of heap and the stack,
+    *   so steady state ticks do not take page faults.
+    * Each step is attempted independently; failures (usually missing CAP_SYS_NICE / CAP_IPC_LOCK
+    * or RLIMIT_MEMLOCK) are logged and reported by returning false.
+    */
+    bool EnableRealTime(int cpu, int priority, size_t prefaultBytes);
+}
+
+#endif  // REAL_TIME_H
@@ -0,0 +1,72 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "RelayAutoTune.h"
+
+using namespace pid_control;
+
+
+RelayAutoTune::RelayAutoTune(const double amplitude, const double hysteresis, const unsigned cycles) :
+	m_amplitude(amplitude), m_hysteresis(hysteresis), m_cycles(cycles)
+{}
+
+double RelayAutoTune::Apply(const double cte, const double dt)
+{
+	m_time += dt;
+	m_cycleMax = std::max(m_cycleMax, cte);
+	m_cycleMin = std::min(m_cycleMin, cte);
+
+	// Steering opposes the error, as in PID::Apply; inside the hysteresis band the output is held
+	double output = m_output;
+	if (cte > m_hysteresis)
+	{
+		output = -m_amplitude;
+	}
+	else if (cte < -m_hysteresis)
+	{
+		output = m_amplitude;
+	}
+	else if (output == 0.0)
+	{
+		output = cte > 0.0 ? -m_amplitude : m_amplitude;
+	}
+
+	if (output > 0.0 && m_output <= 0.0)
+	{
+		// The first rise ends the transient and the second one the first, still distorted, cycle
+		if (m_rises >= 2u && not Done())
+		{
+			m_periodSum += m_time - m_lastRise;
+			m_amplitudeSum += 0.5 * (m_cycleMax - m_cycleMin);
+			m_periods++;
+		}
+		m_rises++;
+		m_lastRise = m_time;
+		m_cycleMax = cte;
+		m_cycleMin = cte;
+	}
+
+	m_output = output;
+	return output;
+}
+
+double RelayAutoTune::GetUltimateGain() const
+{
+	const double a = m_periods > 0u ? m_amplitudeSum / m_periods : 0.0;
+	const double effective = std::sqrt(std::max(a * a - m_hysteresis * m_hysteresis, 1e-12));
+	return 4.0 * m_amplitude / (M_PI * effective);
+}
+
+double RelayAutoTune::GetUltimatePeriod() const
+{
+	return m_periods > 0u ? m_periodSum / m_periods : 0.0;
+}
+
+std::vector<double> RelayAutoTune::GetGains() const
+{
+	// Classic Ziegler–Nichols: kp = 0.6 Ku, Ti = Tu / 2, Td = Tu / 8
+	const double ku = GetUltimateGain();
+	const double tu = GetUltimatePeriod();
+	return {0.6 * ku, 1.2 * ku / tu, 0.075 * ku * tu};
+}
@@ -0,0 +1,61 @@
+#ifndef RELAY_AUTO_TUNE_H
+#define RELAY_AUTO_TUNE_H
+
+
+#include <vector>
+
+namespace pid_control
+{
+	class RelayAutoTune
+	{
+	public:
+		/*
+		* Åström–Hägglund relay feedback auto-tuning.
+		* The car is steered by a relay (bang-bang with hysteresis) on the CTE, which makes it oscillate at the
+		* ultimate period of the loop. From the amplitude `a` of that oscillation, the ultimate gain is
+		*     Ku = 4 h / (pi * sqrt(a^2 - hysteresis^2))
+		* and Ziegler–Nichols rules give the PID gains. Time is measured in the same unit as the dt passed
+		* to Apply, so the gains match PID::Apply with that dt.
+		*/
+		RelayAutoTune(const double amplitude, const double hysteresis, const unsigned cycles);
+
+		/*
+		* Relay output for the given CTE, in the PID's steering convention.
+		*/
+		double Apply(const double cte, const double dt);
+
+		/*
+		* True once `cycles` full oscillations after the first (transient) one were measured.
+		*/
+		bool Done() const { return m_periods >= m_cycles; };
+
+		/*
+		* Ziegler–Nichols {kp, ki, kd}. Only meaningful when Done().
+		*/
+		std::vector<double> GetGains() const;
+
+		double GetUltimateGain() const;
+		double GetUltimatePeriod() const;
+
+	private:
+		const double m_amplitude { 0.0 };
+		const double m_hysteresis { 0.0 };
+		const unsigned m_cycles { 0u };
+
+		double m_output { 0.0 };
+		double m_time { 0.0 };
+
+		// Time of the last switch to positive output; a period is the time between two of them
+		double m_lastRise { -1.0 };
+		unsigned m_rises { 0u };
+
+		double m_cycleMax { 0.0 };
+		double m_cycleMin { 0.0 };
+
+		unsigned m_periods { 0u };
+		double m_periodSum { 0.0 };
+		double m_amplitudeSum { 0.0 };
+	};
+}
+
+#endif  // RELAY_AUTO_TUNE_H
@@ -0,0 +1,294 @@
+#include "ShmChannel.h"
+
+#include <cerrno>
+#include <new>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+using namespace pid_control;
+
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "Shared memory slots need lock-free 64 bit atomics");
+
+// How many spins WaitCommand does between checks of the clock
+static constexpr unsigned SPINS_PER_CLOCK_CHECK = 256u;
+
+/*
+* Layout of the segment. The slots are on their own cache lines, so the two writers never share one.
+* Sequences are odd while their slot is being written; the telemetry sequence is twice the tick.
+* The values are relaxed atomics, which keeps the racy reads the seqlock retries well defined.
+*/
+struct ShmChannel::Shared
+{
+    std::atomic<uint64_t> magic;
+    std::atomic<uint64_t> sessions;
+
+    alignas(64) std::atomic<uint64_t> telemetrySequence;
+    std::atomic<double> cte;
+    std::atomic<double> speed;
+    std::atomic<double> steeringAngle;
+    std::atomic<double> throttle;
+
+    alignas(64) std::atomic<uint64_t> commandSequence;
+    std::atomic<uint64_t> commandTick;
+    std::atomic<uint64_t> commandResets;
+    std::atomic<double> commandSteering;
+    std::atomic<double> commandThrottle;
+};
+
+template<typename Write>
+static void seqlockWrite(std::atomic<uint64_t>& sequence, Write write)
+{
+    const uint64_t start = sequence.load(std::memory_order_relaxed);
+    sequence.store(start + 1u, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    write();
+    sequence.store(start + 2u, std::memory_order_release);
+}
+
+/*
+* Returns the sequence of the consistent read.
+*/
+template<typename Read>
+static uint64_t seqlockRead(const std::atomic<uint64_t>& sequence, Read read)
+{
+    for (;;)
+    {
+        const uint64_t before = sequence.load(std::memory_order_acquire);
+        if ((before & 1u) == 0u)
+        {
+            read();
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before)
+            {
+                return before;
+            }
+        }
+        SpinPause();
+    }
+}
+
+static std::string segmentName(const std::string& name)
+{
+    return name.empty() || name[0] != '/' ? "/" + name : name;
+}
+
+void pid_control::SpinWait(unsigned spins)
+{
+    if (spins < SHM_SPINS_BEFORE_YIELD)
+    {
+        SpinPause();
+    }
+    else
+    {
+        std::this_thread::yield();
+    }
+}
+
+ShmChannel::~ShmChannel()
+{
+    Close();
+}
+
+bool ShmChannel::Create(const std::string& name)
+{
+    Close();
+
+    const std::string path = segmentName(name);
+    shm_unlink(path.c_str());
+    const int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    void* memory = MAP_FAILED;
+    if (ftruncate(fd, sizeof(Shared)) == 0)
+    {
+        memory = mmap(nullptr, sizeof(Shared), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    const int error = errno;
+    close(fd);
+    if (memory == MAP_FAILED)
+    {
+        shm_unlink(path.c_str());
+        errno = error;
+        return false;
+    }
+
+    m_shared = new (memory) Shared();
+    m_name = path;
+    m_telemetrySequence = 0u;
+    m_tick = 0u;
+    m_command = ShmCommand();
+    // Published last, simulators refuse the segment until it is initialized
+    m_shared->magic.store(SHM_MAGIC, std::memory_order_release);
+    return true;
+}
+
+bool ShmChannel::Open(const std::string& name)
+{
+    Close();
+
+    const int fd = shm_open(segmentName(name).c_str(), O_RDWR, 0);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat status {};
+    void* memory = MAP_FAILED;
+    if (fstat(fd, &status) == 0)
+    {
+        if (static_cast<size_t>(status.st_size) >= sizeof(Shared))
+        {
+            memory = mmap(nullptr, sizeof(Shared), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        else
+        {
+            errno = EPROTO;
+        }
+    }
+    const int error = errno;
+    close(fd);
+    if (memory == MAP_FAILED)
+    {
+        errno = error;
+        return false;
+    }
+
+    m_shared = static_cast<Shared*>(memory);
+    if (m_shared->magic.load(std::memory_order_acquire) != SHM_MAGIC)
+    {
+        Close();
+        errno = EPROTO;
+        return false;
+    }
+
+    // Continue the sequence of a previous session, the controller only looks for changes
+    m_telemetrySequence = m_shared->telemetrySequence.load(std::memory_order_relaxed);
+    m_shared->sessions.fetch_add(1u, std::memory_order_acq_rel);
+    return true;
+}
+
+void ShmChannel::Close()
+{
+    if (m_shared == nullptr)
+    {
+        return;
+    }
+
+    munmap(m_shared, sizeof(Shared));
+    m_shared = nullptr;
+    if (not m_name.empty())
+    {
+        shm_unlink(m_name.c_str());
+        m_name.clear();
+    }
+}
+
+uint64_t ShmChannel::PublishTelemetry(const Telemetry& telemetry)
+{
+    Shared& shared = *m_shared;
+    seqlockWrite(shared.telemetrySequence, [&]()
+    {
+        shared.cte.store(telemetry.cte, std::memory_order_relaxed);
+        shared.speed.store(telemetry.speed, std::memory_order_relaxed);
+        shared.steeringAngle.store(telemetry.steeringAngle, std::memory_order_relaxed);
+        shared.throttle.store(telemetry.throttle, std::memory_order_relaxed);
+    });
+    m_telemetrySequence += 2u;
+    return m_telemetrySequence / 2u;
+}
+
+void ShmChannel::ReadCommand(ShmCommand& command) const
+{
+    const Shared& shared = *m_shared;
+    seqlockRead(shared.commandSequence, [&]()
+    {
+        command.tick = shared.commandTick.load(std::memory_order_relaxed);
+        command.resets = shared.commandResets.load(std::memory_order_relaxed);
+        command.steering = shared.commandSteering.load(std::memory_order_relaxed);
+        command.throttle = shared.commandThrottle.load(std::memory_order_relaxed);
+    });
+}
+
+bool ShmChannel::WaitCommand(uint64_t tick, ShmCommand& command, std::chrono::nanoseconds timeout) const
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (unsigned spins = 1u; ; ++spins)
+    {
+        ReadCommand(command);
+        if (command.tick >= tick)
+        {
+            return true;
+        }
+        if (spins % SPINS_PER_CLOCK_CHECK == 0u && std::chrono::steady_clock::now() >= deadline)
+        {
+            return false;
+        }
+        SpinWait(spins);
+    }
+}
+
+bool ShmChannel::PollTelemetry(Telemetry& telemetry)
+{
+    const Shared& shared = *m_shared;
+    // Cheap check first: the line only leaves this core's cache when the simulator wrote to it
+    if (shared.telemetrySequence.load(std::memory_order_acquire) == m_telemetrySequence)
+    {
+        return false;
+    }
+
+    const uint64_t sequence = seqlockRead(shared.telemetrySequence, [&]()
+    {
+        telemetry.cte = shared.cte.load(std::memory_order_relaxed);
+        telemetry.speed = shared.speed.load(std::memory_order_relaxed);
+        telemetry.steeringAngle = shared.steeringAngle.load(std::memory_order_relaxed);
+        telemetry.throttle = shared.throttle.load(std::memory_order_relaxed);
+    });
+    if (sequence == m_telemetrySequence)
+    {
+        return false;
+    }
+    m_telemetrySequence = sequence;
+    m_tick = sequence / 2u;
+    return true;
+}
+
+uint64_t ShmChannel::Sessions() const
+{
+    return m_shared->sessions.load(std::memory_order_acquire);
+}
+
+void ShmChannel::SendSteer(double steering, double throttle)
+{
+    m_command.tick = m_tick;
+    m_command.steering = steering;
+    m_command.throttle = throttle;
+    writeCommand();
+}
+
+void ShmChannel::SendReset()
+{
+    // Does not answer the tick: the steering command that follows does
+    m_command.resets++;
+    writeCommand();
+}
+
+void ShmChannel::writeCommand()
+{
+    Shared& shared = *m_shared;
+    seqlockWrite(shared.commandSequence, [&]()
+    {
+        shared.commandTick.store(m_command.tick, std::memory_order_relaxed);
+        shared.commandResets.store(m_command.resets, std::memory_order_relaxed);
+        shared.commandSteering.store(m_command.steering, std::memory_order_relaxed);
+        shared.commandThrottle.store(m_command.throttle, std::memory_order_relaxed);
+    });
+}
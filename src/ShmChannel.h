@@ -0,0 +1,119 @@
+#ifndef SHM_CHANNEL_H
+#define SHM_CHANNEL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "Telemetry.h"
+
+
+namespace pid_control
+{
+    static constexpr uint64_t SHM_MAGIC = 0x50494453484d0001ull;  // "PIDSHM" and the layout version
+    /*
+    * Waits spin this many times before yielding the CPU on every further spin, so the two sides
+    * still make progress when they share a core.
+    */
+    static constexpr unsigned SHM_SPINS_BEFORE_YIELD = 4096u;
+
+    /*
+    * The latest command of the controller. `tick` is the telemetry tick it answers, `resets` counts the
+    * simulator resets requested so far: a simulator resets whenever it sees the count grow.
+    */
+    struct ShmCommand
+    {
+        uint64_t tick { 0u };
+        uint64_t resets { 0u };
+        double steering { 0.0 };
+        double throttle { 0.0 };
+    };
+
+    /*
+    * Shared memory transport between a simulator and the controller running on the same host.
+    * The segment holds one telemetry slot written by the simulator and one command slot written by the controller,
+    * each protected by a seqlock: the writer never waits, and a reader retries the rare reads that overlapped a write.
+    * Only the latest value of each slot is kept, which is all a control loop needs.
+    *
+    * The controller creates the segment (Create) and the simulator attaches to it (Open). A simulator tick is
+    * PublishTelemetry() followed by WaitCommand() for the returned tick; the controller loops on PollTelemetry()
+    * and answers with SendSteer() or SendReset(). Both sides spin (see SpinWait), so a round trip takes well under
+    * a microsecond when each has a core of its own.
+    *
+    * Functions returning bool leave errno set on failure. Not thread safe: one thread per side.
+    */
+    class ShmChannel
+    {
+    public:
+        ShmChannel() = default;
+        ~ShmChannel();
+
+        ShmChannel(const ShmChannel&) = delete;
+        ShmChannel& operator=(const ShmChannel&) = delete;
+
+        /*
+        * Names are shm_open names, e.g. "/pid"; the leading slash is added when missing.
+        * Create replaces any segment left with the same name, and removes it again on Close.
+        */
+        bool Create(const std::string& name);
+        bool Open(const std::string& name);
+        void Close();
+        bool IsOpen() const { return m_shared != nullptr; };
+
+        // Simulator side
+
+        /*
+        * Publishes a sample and returns its tick, counting from 1.
+        */
+        uint64_t PublishTelemetry(const Telemetry& telemetry);
+        void ReadCommand(ShmCommand& command) const;
+        /*
+        * Spins until the command answering `tick` (or a later one) arrives. Returns false on timeout.
+        */
+        bool WaitCommand(uint64_t tick, ShmCommand& command, std::chrono::nanoseconds timeout) const;
+
+        // Controller side
+
+        /*
+        * Reads the latest sample if it is newer than the previous one polled. Never blocks.
+        */
+        bool PollTelemetry(Telemetry& telemetry);
+        /*
+        * Number of times a simulator attached, so the controller can tell a new session from a continued one.
+        */
+        uint64_t Sessions() const;
+        void SendSteer(double steering, double throttle);
+        void SendReset();
+
+    private:
+        struct Shared;
+
+        void writeCommand();
+
+        Shared* m_shared { nullptr };
+        std::string m_name;  // Set when this side created the segment
+        uint64_t m_telemetrySequence { 0u };
+        uint64_t m_tick { 0u };
+        ShmCommand m_command;
+    };
+
+    /*
+    * Hint to the CPU that this is a spin-wait loop.
+    */
+    inline void SpinPause()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield" ::: "memory");
+#endif
+    }
+
+    /*
+    * One iteration of a wait that has spun `spins` times so far: a pause, or a yield once it spun for long.
+    */
+    void SpinWait(unsigned spins);
+}
+
+#endif  // SHM_CHANNEL_H
@@ -0,0 +1,61 @@
+#include "ShmTransport.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include "spdlog/spdlog.h"
+
+
+using Clock = std::chrono::steady_clock;
+
+using namespace pid_control;
+
+
+ShmTransport::ShmTransport(std::string name) :
+    m_name(std::move(name))
+{
+}
+
+bool ShmTransport::Listen()
+{
+    if (not m_channel.Create(m_name))
+    {
+        spdlog::error("Failed to create shared memory {}: {}", m_name, std::strerror(errno));
+        return false;
+    }
+    spdlog::info("Waiting for telemetry in shared memory {}", m_name);
+    return true;
+}
+
+void ShmTransport::Run()
+{
+    uint64_t sessions = 0u;
+    unsigned spins = 0u;
+    Telemetry telemetry;
+    for (;;)
+    {
+        if (not m_channel.PollTelemetry(telemetry))
+        {
+            SpinWait(++spins);
+            continue;
+        }
+        const auto arrival = Clock::now();
+        spins = 0u;
+        if (m_channel.Sessions() != sessions)
+        {
+            sessions = m_channel.Sessions();
+            m_onConnection();
+        }
+        m_onTelemetry(arrival, telemetry);
+    }
+}
+
+void ShmTransport::SendSteer(double steering, double throttle)
+{
+    m_channel.SendSteer(steering, throttle);
+}
+
+void ShmTransport::SendReset()
+{
+    m_channel.SendReset();
+}
@@ -0,0 +1,33 @@
+#ifndef SHM_TRANSPORT_H
+#define SHM_TRANSPORT_H
+
+#include <string>
+
+#include "ShmChannel.h"
+#include "Transport.h"
+
+
+namespace pid_control
+{
+    /*
+    * Serves a simulator on the same host through a shared memory segment (see ShmChannel), polling it
+    * without ever entering the kernel. Every simulator attaching to the segment starts a new session.
+    */
+    class ShmTransport : public Transport
+    {
+    public:
+        explicit ShmTransport(std::string name);
+
+        const char* Name() const override { return "shm"; };
+        bool Listen() override;
+        void Run() override;
+        void SendSteer(double steering, double throttle) override;
+        void SendReset() override;
+
+    private:
+        const std::string m_name;
+        ShmChannel m_channel;
+    };
+}
+
+#endif  // SHM_TRANSPORT_H
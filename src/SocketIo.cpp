@@ -0,0 +1,381 @@
+#include "SocketIo.h"
+
+#include <cstring>
+
+#include "spdlog/spdlog.h"
+
+
+using namespace pid_control;
+
+
+// Engine.IO v4 separates the packets of a payload with this character; v3 prefixes each with "<length>:"
+static constexpr char PAYLOAD_SEPARATOR = '\x1e';
+static constexpr size_t MIN_TABLE_SIZE = 8u;
+// Reserved for the packets the layer sends itself: pongs, connect confirmations and acknowledgements
+static constexpr size_t PACKET_BUFFER_BYTES = 256u;
+static constexpr size_t RESERVED_ARGUMENTS = 4u;
+
+static uint32_t fnv1a(const char* data, size_t length)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0u; i < length; ++i)
+    {
+        hash = (hash ^ static_cast<uint8_t>(data[i])) * 16777619u;
+    }
+    return hash;
+}
+
+static bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/*
+* Engine.IO v3 payloads give packet lengths in characters as JavaScript counts them, UTF-16 code units:
+* finds the number of UTF-8 bytes holding `units` of them. Returns false when `data` is shorter.
+*/
+static bool utf16UnitsToBytes(const char* data, size_t length, size_t units, size_t& bytes)
+{
+    size_t counted = 0u;
+    bytes = 0u;
+    while (counted < units)
+    {
+        if (bytes >= length)
+        {
+            return false;
+        }
+        const auto lead = static_cast<uint8_t>(data[bytes]);
+        if (lead >= 0xf0u)
+        {
+            // Outside the basic multilingual plane, a surrogate pair
+            bytes += 4u;
+            counted += 2u;
+        }
+        else
+        {
+            bytes += lead >= 0xe0u ? 3u : lead >= 0xc0u ? 2u : 1u;
+            counted++;
+        }
+    }
+    return counted == units && bytes <= length;
+}
+
+SocketIo::SocketIo(Sender sender) :
+    m_sender(std::move(sender)), m_table(MIN_TABLE_SIZE)
+{
+    m_packet.reserve(PACKET_BUFFER_BYTES);
+    m_arguments.reserve(RESERVED_ARGUMENTS);
+}
+
+void SocketIo::On(const std::string& event, EventHandler handler)
+{
+    if ((m_entries + 1u) * 2u > m_table.size())
+    {
+        std::vector<Entry> entries;
+        entries.swap(m_table);
+        m_table.resize(entries.size() * 2u);
+        m_entries = 0u;
+        for (auto& entry : entries)
+        {
+            if (entry.handler)
+            {
+                On(entry.name, std::move(entry.handler));
+            }
+        }
+    }
+
+    const uint32_t hash = fnv1a(event.data(), event.size());
+    const size_t mask = m_table.size() - 1u;
+    size_t slot = hash & mask;
+    while (m_table[slot].handler && m_table[slot].name != event)
+    {
+        slot = (slot + 1u) & mask;
+    }
+    if (not m_table[slot].handler)
+    {
+        m_entries++;
+    }
+    m_table[slot].hash = hash;
+    m_table[slot].name = event;
+    m_table[slot].handler = std::move(handler);
+}
+
+void SocketIo::Receive(const char* data, size_t length)
+{
+    size_t digits = 0u;
+    while (digits < length && isDigit(data[digits]))
+    {
+        digits++;
+    }
+
+    if (digits > 0u && digits < length && data[digits] == ':')
+    {
+        // Engine.IO v3 payload: <length>:<packet><length>:<packet>..., lengths in characters
+        size_t position = 0u;
+        while (position < length)
+        {
+            size_t packetLength = 0u;
+            while (position < length && isDigit(data[position]))
+            {
+                packetLength = packetLength * 10u + static_cast<size_t>(data[position++] - '0');
+            }
+            size_t packetBytes = 0u;
+            if (position >= length || data[position] != ':' ||
+                not utf16UnitsToBytes(data + position + 1u, length - position - 1u, packetLength, packetBytes))
+            {
+                SPDLOG_DEBUG("Malformed Engine.IO payload");
+                return;
+            }
+            receivePacket(data + position + 1u, packetBytes);
+            position += 1u + packetBytes;
+        }
+        return;
+    }
+
+    // A single packet, or an Engine.IO v4 payload of separated packets
+    const char* end = data + length;
+    while (data < end)
+    {
+        const char* separator = static_cast<const char*>(std::memchr(data, PAYLOAD_SEPARATOR, end - data));
+        const char* packetEnd = separator != nullptr ? separator : end;
+        receivePacket(data, packetEnd - data);
+        data = packetEnd + 1;
+    }
+}
+
+void SocketIo::receivePacket(const char* data, size_t length)
+{
+    if (length == 0u)
+    {
+        return;
+    }
+
+    switch (static_cast<EngineIoPacket>(data[0]))
+    {
+    case EngineIoPacket::PING:
+        // Answered with the same payload, e.g. "2probe" with "3probe"
+        m_packet.assign(1u, static_cast<char>(EngineIoPacket::PONG)).append(data + 1, length - 1u);
+        m_sender(m_packet.data(), m_packet.size());
+        break;
+    case EngineIoPacket::MESSAGE:
+        receiveMessage(data + 1, length - 1u);
+        break;
+    default:
+        break;
+    }
+}
+
+void SocketIo::receiveMessage(const char* data, size_t length)
+{
+    if (length == 0u)
+    {
+        return;
+    }
+    const auto type = static_cast<SocketIoPacket>(data[0]);
+    size_t position = 1u;
+
+    if (type == SocketIoPacket::BINARY_EVENT || type == SocketIoPacket::BINARY_ACK)
+    {
+        SPDLOG_DEBUG("Ignoring a Socket.IO packet with binary attachments");
+        return;
+    }
+
+    // Optional namespace, "/name,"
+    const char* nsp = data + position;
+    size_t nspLength = 0u;
+    if (position < length && data[position] == '/')
+    {
+        while (position < length && data[position] != ',')
+        {
+            position++;
+        }
+        nspLength = position - 1u;
+        if (position < length)
+        {
+            position++;
+        }
+    }
+
+    // Optional acknowledgement id
+    const char* ackId = data + position;
+    size_t ackIdLength = 0u;
+    while (position < length && isDigit(data[position]))
+    {
+        position++;
+        ackIdLength++;
+    }
+
+    switch (type)
+    {
+    case SocketIoPacket::CONNECT:
+        // Confirm the connection to the namespace
+        m_packet.assign("40");
+        if (nspLength > 0u)
+        {
+            m_packet.append(nsp, nspLength).push_back(',');
+        }
+        m_sender(m_packet.data(), m_packet.size());
+        break;
+    case SocketIoPacket::EVENT:
+        dispatch(data + position, length - position);
+        if (ackIdLength > 0u)
+        {
+            // Acknowledge with no arguments: "43[/nsp,]<id>[]"
+            m_packet.assign("43");
+            if (nspLength > 0u)
+            {
+                m_packet.append(nsp, nspLength).push_back(',');
+            }
+            m_packet.append(ackId, ackIdLength).append("[]");
+            m_sender(m_packet.data(), m_packet.size());
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void SocketIo::dispatch(const char* data, size_t length)
+{
+    // ["name", arguments...]
+    size_t begin = 0u;
+    size_t end = length;
+    while (begin < end && isSpace(data[begin]))
+    {
+        begin++;
+    }
+    while (end > begin && isSpace(data[end - 1u]))
+    {
+        end--;
+    }
+    if (end - begin < 4u || data[begin] != '[' || data[end - 1u] != ']')
+    {
+        return;
+    }
+    begin++;
+    end--;
+    while (begin < end && isSpace(data[begin]))
+    {
+        begin++;
+    }
+    if (begin >= end || data[begin] != '"')
+    {
+        return;
+    }
+
+    SocketIoEvent event;
+    event.name = data + begin + 1u;
+    const char* quote = static_cast<const char*>(std::memchr(event.name, '"', end - begin - 1u));
+    if (quote == nullptr)
+    {
+        return;
+    }
+    event.nameLength = quote - event.name;
+
+    begin = quote - data + 1u;
+    while (begin < end && isSpace(data[begin]))
+    {
+        begin++;
+    }
+    m_arguments.clear();
+    if (begin < end)
+    {
+        if (data[begin] != ',' || not splitArguments(data, begin + 1u, end))
+        {
+            SPDLOG_DEBUG("Malformed Socket.IO event {}", std::string(event.name, event.nameLength));
+            return;
+        }
+        event.arguments = m_arguments.data();
+        event.argumentCount = m_arguments.size();
+    }
+
+    const Entry* entry = find(event.name, event.nameLength);
+    if (entry == nullptr)
+    {
+        SPDLOG_DEBUG("No handler for Socket.IO event {}", std::string(event.name, event.nameLength));
+        return;
+    }
+    entry->handler(event);
+}
+
+bool SocketIo::splitArguments(const char* data, size_t begin, size_t end)
+{
+    // Split at the commas outside of strings, objects and arrays; the handlers parse the values
+    size_t start = begin;
+    unsigned depth = 0u;
+    bool inString = false;
+    for (size_t position = begin; position <= end; ++position)
+    {
+        if (position < end && inString)
+        {
+            if (data[position] == '\\')
+            {
+                position++;
+            }
+            else if (data[position] == '"')
+            {
+                inString = false;
+            }
+            continue;
+        }
+        if (position < end && data[position] == '"')
+        {
+            inString = true;
+        }
+        else if (position < end && (data[position] == '{' || data[position] == '['))
+        {
+            depth++;
+        }
+        else if (position < end && (data[position] == '}' || data[position] == ']'))
+        {
+            if (depth == 0u)
+            {
+                return false;
+            }
+            depth--;
+        }
+        else if (position == end || (depth == 0u && data[position] == ','))
+        {
+            size_t valueBegin = start;
+            size_t valueEnd = position;
+            while (valueBegin < valueEnd && isSpace(data[valueBegin]))
+            {
+                valueBegin++;
+            }
+            while (valueEnd > valueBegin && isSpace(data[valueEnd - 1u]))
+            {
+                valueEnd--;
+            }
+            if (valueBegin == valueEnd)
+            {
+                return false;
+            }
+            JsonSpan argument;
+            argument.data = data + valueBegin;
+            argument.length = valueEnd - valueBegin;
+            m_arguments.push_back(argument);
+            start = position + 1u;
+        }
+    }
+    return not inString && depth == 0u;
+}
+
+const SocketIo::Entry* SocketIo::find(const char* name, size_t length) const
+{
+    const uint32_t hash = fnv1a(name, length);
+    const size_t mask = m_table.size() - 1u;
+    for (size_t slot = hash & mask; m_table[slot].handler; slot = (slot + 1u) & mask)
+    {
+        const Entry& entry = m_table[slot];
+        if (entry.hash == hash && entry.name.size() == length && std::memcmp(entry.name.data(), name, length) == 0)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,106 @@
+#ifndef SOCKET_IO_H
+#define SOCKET_IO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+
+namespace pid_control
+{
+    /*
+    * Engine.IO packet types, the first character of every packet.
+    */
+    enum class EngineIoPacket : char
+    {
+        OPEN = '0',
+        CLOSE = '1',
+        PING = '2',
+        PONG = '3',
+        MESSAGE = '4',
+        UPGRADE = '5',
+        NOOP = '6',
+    };
+
+    /*
+    * Socket.IO packet types, the character after an Engine.IO MESSAGE.
+    */
+    enum class SocketIoPacket : char
+    {
+        CONNECT = '0',
+        DISCONNECT = '1',
+        EVENT = '2',
+        ACK = '3',
+        ERROR = '4',
+        BINARY_EVENT = '5',
+        BINARY_ACK = '6',
+    };
+
+    /*
+    * The JSON text of one value in a received frame.
+    */
+    struct JsonSpan
+    {
+        const char* data { nullptr };
+        size_t length { 0u };
+
+        bool IsNull() const { return length == 4u && data[0] == 'n'; };
+    };
+
+    /*
+    * A Socket.IO event, pointing into the received frame: only valid during the handler call.
+    * The arguments are the elements of the event array after the name, e.g. the data object of ["telemetry", {...}].
+    */
+    struct SocketIoEvent
+    {
+        const char* name { nullptr };
+        size_t nameLength { 0u };
+        const JsonSpan* arguments { nullptr };
+        size_t argumentCount { 0u };
+    };
+
+    /*
+    * Server side Engine.IO/Socket.IO framing over WebSocket messages. Receive() splits a message into its
+    * Engine.IO packets (a single packet, or a payload of several), answers pings, connects and acknowledgements
+    * through the sender, and dispatches events to the handlers registered with On().
+    * Event names are looked up in a hash table built at registration; the frame is parsed in place, without copies:
+    * the event array is only split into its elements, which the handlers parse.
+    */
+    class SocketIo
+    {
+    public:
+        using Sender = std::function<void(const char* data, size_t length)>;
+        using EventHandler = std::function<void(const SocketIoEvent& event)>;
+
+        explicit SocketIo(Sender sender);
+
+        void On(const std::string& event, EventHandler handler);
+
+        void Receive(const char* data, size_t length);
+
+    private:
+        struct Entry
+        {
+            uint32_t hash { 0u };
+            std::string name;
+            EventHandler handler;
+        };
+
+        void receivePacket(const char* data, size_t length);
+        void receiveMessage(const char* data, size_t length);
+        void dispatch(const char* data, size_t length);
+        bool splitArguments(const char* data, size_t begin, size_t end);
+        const Entry* find(const char* name, size_t length) const;
+
+        Sender m_sender;
+        // Open addressing with linear probing; kept at most half full
+        std::vector<Entry> m_table;
+        size_t m_entries { 0u };
+        std::string m_packet;  // Packets sent by the layer itself
+        std::vector<JsonSpan> m_arguments;  // Of the event being dispatched
+    };
+}
+
+#endif  // SOCKET_IO_H
@@ -0,0 +1,19 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+
+namespace pid_control
+{
+    /*
+    * One telemetry sample of the simulator, independent of how it was transported.
+    */
+    struct Telemetry
+    {
+        double cte { 0.0 };
+        double speed { 0.0 };
+        double steeringAngle { 0.0 };
+        double throttle { 0.0 };
+    };
+}
+
+#endif  // TELEMETRY_H
@@ -0,0 +1,100 @@
+#include "TraceDecode.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "spdlog/fmt/fmt.h"
+
+#include "TraceLog.h"
+
+
+using namespace pid_control;
+
+
+static std::string formatRaw(const std::string& format, const double* args, unsigned count)
+{
+    fmt::memory_buffer raw;
+    fmt::format_to(raw, "Bad format \"{}\":", format);
+    for (unsigned i = 0u; i < count; ++i)
+    {
+        fmt::format_to(raw, " {}", args[i]);
+    }
+    return fmt::to_string(raw);
+}
+
+std::string pid_control::FormatTraceRecord(const std::string& format, const double* args, unsigned count)
+{
+    try
+    {
+        switch (count)
+        {
+        case 1u: return fmt::format(format, args[0]);
+        case 2u: return fmt::format(format, args[0], args[1]);
+        case 3u: return fmt::format(format, args[0], args[1], args[2]);
+        case 4u: return fmt::format(format, args[0], args[1], args[2], args[3]);
+        case 5u: return fmt::format(format, args[0], args[1], args[2], args[3], args[4]);
+        case 6u: return fmt::format(format, args[0], args[1], args[2], args[3], args[4], args[5]);
+        default: return format;
+        }
+    }
+    catch (const fmt::format_error&)
+    {
+        // The format comes from the file, e.g. a stray '{' or "{:d}" for a double
+        return formatRaw(format, args, count);
+    }
+}
+
+bool pid_control::DecodeTrace(FILE* in, const std::function<void(const std::string& line)>& emit, std::string& error)
+{
+    char magic[sizeof(TRACE_MAGIC)];
+    uint32_t version = 0u;
+    uint32_t count = 0u;
+    if (std::fread(magic, sizeof(magic), 1u, in) != 1u || std::memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0 ||
+        std::fread(&version, sizeof(version), 1u, in) != 1u || version != TRACE_VERSION ||
+        std::fread(&count, sizeof(count), 1u, in) != 1u)
+    {
+        error = fmt::format("not a version {} trace file", TRACE_VERSION);
+        return false;
+    }
+
+    std::vector<std::string> formats(count);
+    for (auto& format : formats)
+    {
+        uint16_t length = 0u;
+        if (std::fread(&length, sizeof(length), 1u, in) != 1u)
+        {
+            error = "Truncated format table";
+            return false;
+        }
+        format.resize(length);
+        if (length > 0u && std::fread(&format[0], 1u, length, in) != length)
+        {
+            error = "Truncated format table";
+            return false;
+        }
+    }
+
+    uint64_t first = 0u;
+    uint64_t records = 0u;
+    uint64_t nanos = 0u;
+    while (std::fread(&nanos, sizeof(nanos), 1u, in) == 1u)
+    {
+        uint16_t format = 0u;
+        uint16_t args = 0u;
+        double values[TRACE_MAX_ARGS];
+        if (std::fread(&format, sizeof(format), 1u, in) != 1u || std::fread(&args, sizeof(args), 1u, in) != 1u ||
+            args > TRACE_MAX_ARGS || std::fread(values, sizeof(double), args, in) != args)
+        {
+            error = fmt::format("Truncated record after {} records", records);
+            break;
+        }
+
+        first = records == 0u ? nanos : first;
+        const std::string text = format < formats.size() ? FormatTraceRecord(formats[format], values, args)
+                                                         : fmt::format("Unknown format {}", format);
+        emit(fmt::format("{:.6f} {}", (nanos - first) * 1e-9, text));
+        records++;
+    }
+    return true;
+}
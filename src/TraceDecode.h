@@ -0,0 +1,26 @@
+#ifndef TRACE_DECODE_H
+#define TRACE_DECODE_H
+
+#include <cstdio>
+#include <functional>
+#include <string>
+
+
+namespace pid_control
+{
+    /*
+    * Formats one record with its format from the trace's table; the argument count picks how many values
+    * are handed to fmt. A format fmt rejects, e.g. from a corrupt table, gives the raw format and the values.
+    */
+    std::string FormatTraceRecord(const std::string& format, const double* args, unsigned count);
+
+    /*
+    * Decodes a binary trace written by TraceLog (see TraceLog.h for the layout) into text, calling `emit` with
+    * one line per record, prefixed by the seconds elapsed since the first record.
+    * Returns false, with `error` set, when `in` is not a trace file. A truncated record ends the decoding and
+    * sets `error`, but still returns true.
+    */
+    bool DecodeTrace(FILE* in, const std::function<void(const std::string& line)>& emit, std::string& error);
+}
+
+#endif  // TRACE_DECODE_H
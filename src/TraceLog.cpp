@@ -0,0 +1,134 @@
+#include "TraceLog.h"
+
+#include <chrono>
+
+#include "spdlog/spdlog.h"
+
+
+using namespace pid_control;
+
+
+// How long the writer thread sleeps when the ring is empty
+static constexpr auto WRITER_IDLE = std::chrono::milliseconds(1);
+
+static size_t roundUpPow2(size_t n)
+{
+    size_t pow2 = 2u;
+    while (pow2 < n)
+    {
+        pow2 <<= 1u;
+    }
+    return pow2;
+}
+
+TraceLog::TraceLog(size_t capacity) :
+    m_mask(roundUpPow2(capacity) - 1u), m_ring(new Record[m_mask + 1u])
+{
+}
+
+TraceLog::~TraceLog()
+{
+    Close();
+}
+
+uint16_t TraceLog::Register(const std::string& format)
+{
+    m_formats.push_back(format);
+    return static_cast<uint16_t>(m_formats.size() - 1u);
+}
+
+bool TraceLog::Open(const std::string& path)
+{
+    Close();
+
+    m_file = std::fopen(path.c_str(), "wb");
+    if (m_file == nullptr)
+    {
+        spdlog::error("Could not open trace file {}", path);
+        return false;
+    }
+
+    const uint32_t count = static_cast<uint32_t>(m_formats.size());
+    std::fwrite(TRACE_MAGIC, sizeof(TRACE_MAGIC), 1u, m_file);
+    std::fwrite(&TRACE_VERSION, sizeof(TRACE_VERSION), 1u, m_file);
+    std::fwrite(&count, sizeof(count), 1u, m_file);
+    for (const auto& format : m_formats)
+    {
+        const uint16_t length = static_cast<uint16_t>(format.size());
+        std::fwrite(&length, sizeof(length), 1u, m_file);
+        std::fwrite(format.data(), 1u, length, m_file);
+    }
+
+    m_running = true;
+    m_writer = std::thread(&TraceLog::writerLoop, this);
+    return true;
+}
+
+void TraceLog::Close()
+{
+    if (m_file == nullptr)
+    {
+        return;
+    }
+
+    m_running = false;
+    m_writer.join();
+    drain();
+    std::fclose(m_file);
+    m_file = nullptr;
+
+    if (Dropped() > 0u)
+    {
+        spdlog::warn("Trace log dropped {} records", Dropped());
+    }
+}
+
+void TraceLog::Write(uint16_t format, const double* args, unsigned count)
+{
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    if (m_file == nullptr || head - m_tail.load(std::memory_order_acquire) > m_mask)
+    {
+        m_dropped.fetch_add(1u, std::memory_order_relaxed);
+        return;
+    }
+
+    Record& record = m_ring[head & m_mask];
+    record.nanos = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+    record.format = format;
+    record.count = static_cast<uint16_t>(count);
+    for (unsigned i = 0u; i < count; ++i)
+    {
+        record.args[i] = args[i];
+    }
+    m_head.store(head + 1u, std::memory_order_release);
+}
+
+void TraceLog::writerLoop()
+{
+    while (m_running)
+    {
+        if (drain() == 0u)
+        {
+            std::fflush(m_file);
+            std::this_thread::sleep_for(WRITER_IDLE);
+        }
+    }
+}
+
+size_t TraceLog::drain()
+{
+    const size_t head = m_head.load(std::memory_order_acquire);
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    const size_t drained = head - tail;
+    for (; tail != head; ++tail)
+    {
+        const Record& record = m_ring[tail & m_mask];
+        std::fwrite(&record.nanos, sizeof(record.nanos), 1u, m_file);
+        std::fwrite(&record.format, sizeof(record.format), 1u, m_file);
+        std::fwrite(&record.count, sizeof(record.count), 1u, m_file);
+        std::fwrite(record.args, sizeof(double), record.count, m_file);
+        m_tail.store(tail + 1u, std::memory_order_release);
+    }
+    return drained;
+}
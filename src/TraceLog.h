@@ -0,0 +1,84 @@
+#ifndef TRACE_LOG_H
+#define TRACE_LOG_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace pid_control
+{
+    /*
+    * Binary trace file layout, in native byte order:
+    *   header:  TRACE_MAGIC, uint32 version, uint32 format count, then per format a uint16 length and its bytes
+    *   records: uint64 nanoseconds (steady clock), uint16 format id, uint16 argument count, the arguments as doubles
+    * Format ids are indices into the header's table; formats use fmt's "{}" placeholders.
+    */
+    static constexpr char TRACE_MAGIC[8] = {'P', 'I', 'D', 'T', 'R', 'A', 'C', 'E'};
+    static constexpr uint32_t TRACE_VERSION = 1u;
+    static constexpr unsigned TRACE_MAX_ARGS = 6u;
+
+    /*
+    * Deferred-format binary logger for per-tick tracing. The control thread only copies a format id and raw
+    * argument values into a lock-free single-producer ring; a background thread writes them to disk, and
+    * formatting is left to the offline decoder (pid_trace_decode).
+    * Records are dropped, and counted, when the ring is full. Only one thread may call Log().
+    */
+    class TraceLog
+    {
+    public:
+        explicit TraceLog(size_t capacity = 4096u);
+        ~TraceLog();
+
+        /*
+        * Adds a format to the table and returns its id. All formats must be registered before Open().
+        */
+        uint16_t Register(const std::string& format);
+
+        bool Open(const std::string& path);
+        void Close();
+        bool IsOpen() const { return m_file != nullptr; };
+
+        template<typename... Args>
+        void Log(uint16_t format, Args... args)
+        {
+            static_assert(sizeof...(Args) >= 1u && sizeof...(Args) <= TRACE_MAX_ARGS, "Unsupported argument count");
+            const double values[] = {static_cast<double>(args)...};
+            Write(format, values, sizeof...(Args));
+        }
+
+        void Write(uint16_t format, const double* args, unsigned count);
+
+        uint64_t Dropped() const { return m_dropped.load(std::memory_order_relaxed); };
+
+    private:
+        struct Record
+        {
+            uint64_t nanos;
+            uint16_t format;
+            uint16_t count;
+            double args[TRACE_MAX_ARGS];
+        };
+
+        void writerLoop();
+        size_t drain();
+
+        std::vector<std::string> m_formats;
+
+        const size_t m_mask { 0u };
+        std::unique_ptr<Record[]> m_ring;
+        alignas(64) std::atomic<size_t> m_head { 0u };  // Next slot to write, owned by the producer
+        alignas(64) std::atomic<size_t> m_tail { 0u };  // Next slot to read, owned by the writer thread
+        alignas(64) std::atomic<uint64_t> m_dropped { 0u };
+
+        FILE* m_file { nullptr };
+        std::atomic<bool> m_running { false };
+        std::thread m_writer;
+    };
+}
+
+#endif  // TRACE_LOG_H
@@ -0,0 +1,274 @@
+#include "Track.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+
+using namespace pid_control;
+
+
+// Default track: a star-shaped polar curve r(t) = R (1 + sum a_k cos(k t + phase_k)), which never self-intersects
+static constexpr double DEFAULT_RADIUS = 150.0;
+static constexpr unsigned DEFAULT_POINTS = 600u;
+
+// Generated tracks: radius range, number and size of the harmonics. The amplitudes of all harmonics
+// sum to less than 1, so the radius stays positive, and fall off with the order, so corners stay wide enough.
+static constexpr double MIN_GENERATED_RADIUS = 100.0;
+static constexpr double MAX_GENERATED_RADIUS = 200.0;
+static constexpr unsigned MIN_HARMONIC = 2u;
+static constexpr unsigned MAX_HARMONIC = 6u;
+static constexpr double MAX_HARMONIC_AMPLITUDE = 0.6;  // Divided by the order
+static constexpr double MAX_TOTAL_AMPLITUDE = 0.5;
+
+// Spatial index configuration
+static constexpr double GRID_CELL = 10.0;            // m
+static constexpr double GRID_MARGIN = 2.0 * GRID_CELL;
+// Segments the hint walk may advance before giving up on the hint
+static constexpr unsigned MAX_WALK = 16u;
+// A local minimum found by walking is trusted only this close to the track; well below the distance
+// between different parts of the track, and above the CTE at which episodes are terminated
+static constexpr double MAX_WALK_DISTANCE = 5.0;
+
+Track::Track(std::vector<Point> centerline) :
+    m_points(std::move(centerline))
+{
+    buildIndex();
+}
+
+void Track::buildIndex()
+{
+    double maxX = -std::numeric_limits<double>::max();
+    double maxY = -std::numeric_limits<double>::max();
+    m_minX = std::numeric_limits<double>::max();
+    m_minY = std::numeric_limits<double>::max();
+    for (const Point& p : m_points)
+    {
+        m_minX = std::min(m_minX, p.x);
+        m_minY = std::min(m_minY, p.y);
+        maxX = std::max(maxX, p.x);
+        maxY = std::max(maxY, p.y);
+    }
+    m_minX -= GRID_MARGIN;
+    m_minY -= GRID_MARGIN;
+    m_cols = static_cast<unsigned>((maxX + GRID_MARGIN - m_minX) / GRID_CELL) + 1u;
+    m_rows = static_cast<unsigned>((maxY + GRID_MARGIN - m_minY) / GRID_CELL) + 1u;
+
+    // Counting sort of (cell, segment) pairs for every cell a segment's bounding box touches
+    std::vector<std::pair<unsigned, unsigned>> entries;
+    for (size_t i = 0u; i < m_points.size(); ++i)
+    {
+        const Point& a = m_points[i];
+        const Point& b = m_points[(i + 1u) % m_points.size()];
+        const unsigned c0 = static_cast<unsigned>((std::min(a.x, b.x) - m_minX) / GRID_CELL);
+        const unsigned c1 = static_cast<unsigned>((std::max(a.x, b.x) - m_minX) / GRID_CELL);
+        const unsigned r0 = static_cast<unsigned>((std::min(a.y, b.y) - m_minY) / GRID_CELL);
+        const unsigned r1 = static_cast<unsigned>((std::max(a.y, b.y) - m_minY) / GRID_CELL);
+        for (unsigned r = r0; r <= r1; ++r)
+        {
+            for (unsigned c = c0; c <= c1; ++c)
+            {
+                entries.push_back({r * m_cols + c, static_cast<unsigned>(i)});
+            }
+        }
+    }
+
+    m_cellStart.assign(m_cols * m_rows + 1u, 0u);
+    for (const auto& entry : entries)
+    {
+        m_cellStart[entry.first + 1u]++;
+    }
+    for (size_t i = 1u; i < m_cellStart.size(); ++i)
+    {
+        m_cellStart[i] += m_cellStart[i - 1u];
+    }
+    m_cellSegments.resize(entries.size());
+    std::vector<unsigned> fill(m_cellStart.begin(), m_cellStart.end() - 1);
+    for (const auto& entry : entries)
+    {
+        m_cellSegments[fill[entry.first]++] = entry.second;
+    }
+}
+
+Track Track::fromHarmonics(double radius, const std::vector<Harmonic>& harmonics)
+{
+    std::vector<Point> points;
+    points.reserve(DEFAULT_POINTS);
+    for (unsigned i = 0u; i < DEFAULT_POINTS; ++i)
+    {
+        const double t = 2.0 * M_PI * i / DEFAULT_POINTS;
+        double r = 1.0;
+        for (const auto& h : harmonics)
+        {
+            r += h.amplitude * std::cos(h.order * t + h.phase);
+        }
+        points.push_back({radius * r * std::cos(t), radius * r * std::sin(t)});
+    }
+    return Track(std::move(points));
+}
+
+Track Track::Default()
+{
+    return fromHarmonics(DEFAULT_RADIUS, {
+        {2.0, 0.30, 0.0},
+        {3.0, 0.15, 1.0},
+        {5.0, 0.05, 2.0},
+    });
+}
+
+Track Track::Generate(unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    const double radius = MIN_GENERATED_RADIUS + unit(rng) * (MAX_GENERATED_RADIUS - MIN_GENERATED_RADIUS);
+
+    std::vector<Harmonic> harmonics;
+    double total = 0.0;
+    for (unsigned order = MIN_HARMONIC; order <= MAX_HARMONIC; ++order)
+    {
+        const double amplitude = unit(rng) * MAX_HARMONIC_AMPLITUDE / order;
+        harmonics.push_back({static_cast<double>(order), amplitude, unit(rng) * 2.0 * M_PI});
+        total += amplitude;
+    }
+    if (total > MAX_TOTAL_AMPLITUDE)
+    {
+        for (auto& h : harmonics)
+        {
+            h.amplitude *= MAX_TOTAL_AMPLITUDE / total;
+        }
+    }
+    return fromHarmonics(radius, harmonics);
+}
+
+double Track::Heading(size_t segment) const
+{
+    const Point& a = m_points[segment];
+    const Point& b = m_points[(segment + 1u) % m_points.size()];
+    return std::atan2(b.y - a.y, b.x - a.x);
+}
+
+double Track::distanceToSegment(double x, double y, size_t segment) const
+{
+    const Point& a = m_points[segment];
+    const Point& b = m_points[(segment + 1u) % m_points.size()];
+    const double dx = b.x - a.x;
+    const double dy = b.y - a.y;
+    const double length2 = dx * dx + dy * dy;
+
+    double t = length2 > 0.0 ? ((x - a.x) * dx + (y - a.y) * dy) / length2 : 0.0;
+    t = t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t);
+    const double px = x - (a.x + t * dx);
+    const double py = y - (a.y + t * dy);
+    const double distance = std::sqrt(px * px + py * py);
+
+    // Right of the driving direction when the cross product of the direction and the offset is negative
+    return dx * (y - a.y) - dy * (x - a.x) > 0.0 ? -distance : distance;
+}
+
+bool Track::walkFrom(double x, double y, size_t& segment, double& distance) const
+{
+    const size_t n = m_points.size();
+    distance = distanceToSegment(x, y, segment);
+
+    // Walk forward while the next segment is closer, then backward
+    for (const size_t step : {size_t(1u), n - 1u})
+    {
+        for (unsigned i = 0u; i < MAX_WALK; ++i)
+        {
+            const size_t next = (segment + step) % n;
+            const double d = distanceToSegment(x, y, next);
+            if (std::abs(d) >= std::abs(distance))
+            {
+                break;
+            }
+            distance = d;
+            segment = next;
+            if (i + 1u == MAX_WALK)
+            {
+                return false;
+            }
+        }
+    }
+    return std::abs(distance) <= MAX_WALK_DISTANCE;
+}
+
+double Track::searchGrid(double x, double y, size_t& segment) const
+{
+    const double cx = (x - m_minX) / GRID_CELL;
+    const double cy = (y - m_minY) / GRID_CELL;
+    if (cx < 0.0 || cy < 0.0 || cx >= m_cols || cy >= m_rows)
+    {
+        return searchAll(x, y, segment);
+    }
+    const int col = static_cast<int>(cx);
+    const int row = static_cast<int>(cy);
+
+    // Search rings of cells around the point's cell. Cells beyond ring r are at least r cells away,
+    // so the search ends as soon as the best distance is within that.
+    double best = std::numeric_limits<double>::max();
+    const int maxRing = static_cast<int>(std::max(m_cols, m_rows));
+    for (int ring = 0; ring <= maxRing; ++ring)
+    {
+        for (int r = row - ring; r <= row + ring; ++r)
+        {
+            if (r < 0 || r >= static_cast<int>(m_rows))
+            {
+                continue;
+            }
+            // Only the perimeter of the ring: every column on the top and bottom rows, the two ends otherwise
+            const bool edgeRow = r == row - ring || r == row + ring;
+            const int stride = edgeRow || ring == 0 ? 1 : 2 * ring;
+            for (int c = col - ring; c <= col + ring; c += stride)
+            {
+                if (c < 0 || c >= static_cast<int>(m_cols))
+                {
+                    continue;
+                }
+                const unsigned cell = static_cast<unsigned>(r) * m_cols + static_cast<unsigned>(c);
+                for (unsigned k = m_cellStart[cell]; k < m_cellStart[cell + 1u]; ++k)
+                {
+                    const double distance = distanceToSegment(x, y, m_cellSegments[k]);
+                    if (std::abs(distance) < std::abs(best))
+                    {
+                        best = distance;
+                        segment = m_cellSegments[k];
+                    }
+                }
+            }
+        }
+        if (std::abs(best) <= ring * GRID_CELL)
+        {
+            break;
+        }
+    }
+    return best;
+}
+
+double Track::Cte(double x, double y, size_t& segment) const
+{
+    double distance = 0.0;
+    if (segment < m_points.size() && walkFrom(x, y, segment, distance))
+    {
+        return distance;
+    }
+    return searchGrid(x, y, segment);
+}
+
+double Track::searchAll(double x, double y, size_t& segment) const
+{
+    double best = std::numeric_limits<double>::max();
+    for (size_t i = 0u; i < m_points.size(); ++i)
+    {
+        const double distance = distanceToSegment(x, y, i);
+        if (std::abs(distance) < std::abs(best))
+        {
+            best = distance;
+            segment = i;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,82 @@
+#ifndef TRACK_H
+#define TRACK_H
+
+#include <cstddef>
+#include <vector>
+
+
+namespace pid_control
+{
+    struct Point
+    {
+        double x;
+        double y;
+    };
+
+    /*
+    * Closed loop track centerline for the headless simulator, as a polyline in meters.
+    * Segments are indexed in a uniform grid so the nearest one is found without scanning the whole track.
+    */
+    class Track
+    {
+    public:
+        /*
+        * The last point connects back to the first one.
+        */
+        explicit Track(std::vector<Point> centerline);
+
+        /*
+        * Built-in loop of about a kilometer: a smooth star-shaped curve of three low order harmonics,
+        * with long sweepers of varying curvature and no straights.
+        */
+        static Track Default();
+
+        /*
+        * Random loop for the given seed: a star-shaped curve around the origin, with a random size and
+        * a random mix of low order harmonics in its radius, so it never crosses itself and stays drivable.
+        */
+        static Track Generate(unsigned seed);
+
+        size_t Segments() const { return m_points.size(); };
+        const Point& Start(size_t segment) const { return m_points[segment]; };
+        double Heading(size_t segment) const;
+
+        /*
+        * Signed distance from (x, y) to the centerline, positive to the right of the driving direction,
+        * like the simulator's CTE. `segment` is set to the segment the distance was measured to.
+        * On input, `segment` is a hint: the segment found for the same car on the previous tick.
+        * The search walks along the track from it, which is O(1) for a car that moved less than a few segments,
+        * and falls back to the grid when the hint is out of range or the car is far from the track.
+        */
+        double Cte(double x, double y, size_t& segment) const;
+
+    private:
+        struct Harmonic
+        {
+            double order;
+            double amplitude;
+            double phase;
+        };
+
+        static Track fromHarmonics(double radius, const std::vector<Harmonic>& harmonics);
+
+        double distanceToSegment(double x, double y, size_t segment) const;
+
+        void buildIndex();
+        bool walkFrom(double x, double y, size_t& segment, double& distance) const;
+        double searchGrid(double x, double y, size_t& segment) const;
+        double searchAll(double x, double y, size_t& segment) const;
+
+        std::vector<Point> m_points;
+
+        // Uniform grid over the bounding box; cell i holds m_cellSegments[m_cellStart[i] .. m_cellStart[i + 1])
+        double m_minX { 0.0 };
+        double m_minY { 0.0 };
+        unsigned m_cols { 0u };
+        unsigned m_rows { 0u };
+        std::vector<unsigned> m_cellStart;
+        std::vector<unsigned> m_cellSegments;
+    };
+}
+
+#endif  // TRACK_H
@@ -0,0 +1,76 @@
+#include "Transport.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "spdlog/spdlog.h"
+
+#include "Protocol.h"
+#include "ShmTransport.h"
+#include "UnixSocketTransport.h"
+#include "WebSocketTransport.h"
+#ifdef PID_HAVE_IO_URING
+#include "UringTransport.h"
+#endif
+
+
+using std::string;
+
+using namespace pid_control;
+
+
+/*
+* Parses the comma separated binary protocols clients may negotiate.
+*/
+static bool parseAllowedProtocols(const string& list, std::vector<WireProtocol>& allowedProtocols)
+{
+    for (size_t begin = 0u; begin < list.size(); )
+    {
+        const size_t end = std::min(list.find(',', begin), list.size());
+        const string name = list.substr(begin, end - begin);
+        WireProtocol allowed;
+        if (not ParseProtocolName(name, allowed) || allowed == WireProtocol::TEXT)
+        {
+            spdlog::error("Unknown binary protocol: {}", name);
+            return false;
+        }
+        allowedProtocols.push_back(allowed);
+        begin = end + 1u;
+    }
+    return true;
+}
+
+std::unique_ptr<Transport> pid_control::CreateTransport(const Options& options)
+{
+    if (options.transport == "websocket")
+    {
+        std::vector<WireProtocol> allowedProtocols;
+        if (not parseAllowedProtocols(options.protocols, allowedProtocols))
+        {
+            return nullptr;
+        }
+        return std::unique_ptr<Transport>(new WebSocketTransport(static_cast<int>(options.port),
+                                                                 std::move(allowedProtocols)));
+    }
+    if (options.transport == "shm")
+    {
+        return std::unique_ptr<Transport>(new ShmTransport(options.shmName));
+    }
+    if (options.transport == "unix")
+    {
+        return std::unique_ptr<Transport>(new UnixSocketTransport(options.socketPath));
+    }
+    if (options.transport == "io_uring")
+    {
+#ifdef PID_HAVE_IO_URING
+        return std::unique_ptr<Transport>(new UringTransport(static_cast<int>(options.port)));
+#else
+        spdlog::error("The io_uring transport is not available, pid was built without liburing");
+        return nullptr;
+#endif
+    }
+
+    spdlog::error("Unknown transport: {}", options.transport);
+    return nullptr;
+}
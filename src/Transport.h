@@ -0,0 +1,60 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <chrono>
+#include <functional>
+#include <memory>
+
+#include "Options.h"
+#include "Telemetry.h"
+
+
+namespace pid_control
+{
+    /*
+    * How the controller exchanges telemetry and commands with the simulator. The control loop registers its
+    * handlers, Listen()s, then hands the calling thread to Run(), which calls the handlers from its event loop.
+    * One simulator is served at a time; the connection handler marks the start of each session.
+    */
+    class Transport
+    {
+    public:
+        using TelemetryHandler = std::function<void(std::chrono::steady_clock::time_point arrival,
+                                                    const Telemetry& telemetry)>;
+        using ConnectionHandler = std::function<void()>;
+
+        virtual ~Transport() = default;
+
+        void OnTelemetry(TelemetryHandler handler) { m_onTelemetry = std::move(handler); };
+        void OnConnection(ConnectionHandler handler) { m_onConnection = std::move(handler); };
+
+        virtual const char* Name() const = 0;
+
+        /*
+        * Binds the endpoint. Returns false (after logging the reason) on failure.
+        */
+        virtual bool Listen() = 0;
+
+        /*
+        * Serves simulators until a fatal error.
+        */
+        virtual void Run() = 0;
+
+        /*
+        * Commands to the simulator whose telemetry is being handled; only called from the telemetry handler.
+        */
+        virtual void SendSteer(double steering, double throttle) = 0;
+        virtual void SendReset() = 0;
+
+    protected:
+        TelemetryHandler m_onTelemetry;
+        ConnectionHandler m_onConnection;
+    };
+
+    /*
+    * The transport selected by the options, or nullptr (after logging the reason) if it is unknown or unavailable.
+    */
+    std::unique_ptr<Transport> CreateTransport(const Options& options);
+}
+
+#endif  // TRANSPORT_H
@@ -0,0 +1,34 @@
+#ifndef TUNER_H
+#define TUNER_H
+
+
+#include <vector>
+
+namespace pid_control
+{
+	class Tuner
+	{
+	public:
+		/*
+		* Common interface of the episode based parameter optimizers.
+		* The caller runs an episode with `params`, then hands its error back to runOnce, which replaces
+		* `params` with the next parameters to evaluate. Returns true when completed, with `params` set to the best found.
+		*/
+		virtual ~Tuner() = default;
+
+		virtual bool runOnce(const double error, std::vector<double>& params) = 0;
+
+		/*
+		* Length of the next episode, for tuners that evaluate candidates at several fidelities.
+		* Defaults to the full `maxTicks`.
+		*/
+		virtual unsigned GetEpisodeTicks(const unsigned maxTicks) const { return maxTicks; }
+
+		/*
+		* The best parameters evaluated so far, the incumbent. Empty until a candidate qualifies.
+		*/
+		virtual std::vector<double> GetBestParams() const = 0;
+	};
+}
+
+#endif  // TUNER_H
@@ -5,6 +5,8 @@
 #include <limits>
 #include <vector>
 
+#include "Tuner.h"
+
 namespace pid_control
 {
 	enum State {
@@ -13,7 +15,7 @@ namespace pid_control
 		CONCLUDE
 	};
 
-	class Twiddle
+	class Twiddle : public Tuner
 	{
 	public:
 		/*
@@ -26,11 +28,13 @@ namespace pid_control
 		* Twiddle with the values of the parameters once, hopefully minimizing the error of the next run.
 		* Returns true when completed.
 		*/
-		bool runOnce(const double prevError, std::vector<double>& params);
+		bool runOnce(const double prevError, std::vector<double>& params) override;
 
 		std::vector<double> GetCoefficients() { return m_coeffs; };
 		void SetCoefficients(const std::vector<double>& coeffs) { m_coeffs = coeffs; };
 
+		std::vector<double> GetBestParams() const override { return m_bestParams; };
+
 	private:
 		const double m_tolerance { 0.0 };
 
@@ -0,0 +1,169 @@
+#include "UnixSocketTransport.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "spdlog/spdlog.h"
+
+
+using Clock = std::chrono::steady_clock;
+
+using namespace pid_control;
+
+
+UnixSocketTransport::UnixSocketTransport(std::string path) :
+    m_path(std::move(path))
+{
+}
+
+UnixSocketTransport::~UnixSocketTransport()
+{
+    if (m_client >= 0)
+    {
+        close(m_client);
+    }
+    if (m_listener >= 0)
+    {
+        close(m_listener);
+    }
+    if (m_bound)
+    {
+        // Only the socket file this transport created
+        unlink(m_path.c_str());
+    }
+}
+
+bool UnixSocketTransport::Listen()
+{
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    if (m_path.size() >= sizeof(address.sun_path))
+    {
+        spdlog::error("Unix socket path too long: {}", m_path);
+        return false;
+    }
+    std::memcpy(address.sun_path, m_path.c_str(), m_path.size() + 1u);
+
+    m_listener = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_listener < 0)
+    {
+        spdlog::error("Failed to create a Unix socket: {}", std::strerror(errno));
+        return false;
+    }
+    // A socket file left by a previous run would make bind fail; anything else at the path is not ours to remove
+    struct stat existing;
+    if (lstat(m_path.c_str(), &existing) == 0)
+    {
+        if (not S_ISSOCK(existing.st_mode))
+        {
+            spdlog::error("Not listening to {}: it exists and is not a socket", m_path);
+            close(m_listener);
+            m_listener = -1;
+            return false;
+        }
+        unlink(m_path.c_str());
+    }
+    m_bound = bind(m_listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+    if (not m_bound || listen(m_listener, 1) != 0)
+    {
+        spdlog::error("Failed to listen to {}: {}", m_path, std::strerror(errno));
+        close(m_listener);
+        m_listener = -1;
+        return false;
+    }
+    spdlog::info("Listening to {}", m_path);
+    return true;
+}
+
+void UnixSocketTransport::Run()
+{
+    for (;;)
+    {
+        m_client = accept4(m_listener, nullptr, nullptr, SOCK_CLOEXEC);
+        if (m_client < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            spdlog::error("Failed to accept on {}: {}", m_path, std::strerror(errno));
+            return;
+        }
+
+        m_reader.Reset();
+        m_onConnection();
+        serve();
+        close(m_client);
+        m_client = -1;
+        spdlog::info("Disconnected");
+    }
+}
+
+void UnixSocketTransport::serve()
+{
+    Telemetry telemetry;
+    bool malformed = false;
+    for (;;)
+    {
+        const ssize_t received = recv(m_client, m_reader.WritePointer(), m_reader.WriteSpace(), 0);
+        if (received < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (received <= 0)
+        {
+            return;
+        }
+
+        const auto arrival = Clock::now();
+        m_reader.Commit(static_cast<size_t>(received));
+        while (m_reader.Next(telemetry, malformed))
+        {
+            m_onTelemetry(arrival, telemetry);
+        }
+        if (malformed)
+        {
+            spdlog::error("Received a frame that is not STRUCT telemetry, closing the connection");
+            return;
+        }
+    }
+}
+
+void UnixSocketTransport::SendSteer(double steering, double throttle)
+{
+    m_message.clear();
+    EncodeSteer(WireProtocol::STRUCT, steering, throttle, m_message);
+    send();
+}
+
+void UnixSocketTransport::SendReset()
+{
+    m_message.clear();
+    EncodeReset(WireProtocol::STRUCT, m_message);
+    send();
+}
+
+void UnixSocketTransport::send()
+{
+    size_t sent = 0u;
+    while (sent < m_message.size())
+    {
+        const ssize_t written = ::send(m_client, m_message.data() + sent, m_message.size() - sent, MSG_NOSIGNAL);
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written < 0)
+        {
+            // The next recv notices the connection is gone
+            SPDLOG_DEBUG("Failed to send to {}: {}", m_path, std::strerror(errno));
+            return;
+        }
+        sent += static_cast<size_t>(written);
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef UNIX_SOCKET_TRANSPORT_H
+#define UNIX_SOCKET_TRANSPORT_H
+
+#include <string>
+
+#include "Protocol.h"
+#include "Transport.h"
+
+
+namespace pid_control
+{
+    /*
+    * Serves a simulator on the same host through a Unix domain stream socket, with STRUCT frames (see Protocol.h)
+    * in both directions. Skips the TCP stack, WebSocket framing and JSON; each tick is one recv and one send.
+    */
+    class UnixSocketTransport : public Transport
+    {
+    public:
+        explicit UnixSocketTransport(std::string path);
+        ~UnixSocketTransport();
+
+        const char* Name() const override { return "unix"; };
+        bool Listen() override;
+        void Run() override;
+        void SendSteer(double steering, double throttle) override;
+        void SendReset() override;
+
+    private:
+        void serve();
+        void send();
+
+        const std::string m_path;
+        int m_listener { -1 };
+        // Whether bind created the socket file, which is then removed on destruction
+        bool m_bound { false };
+        int m_client { -1 };
+        StructStreamReader m_reader;
+        fmt::memory_buffer m_message;
+    };
+}
+
+#endif  // UNIX_SOCKET_TRANSPORT_H
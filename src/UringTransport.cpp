@@ -0,0 +1,239 @@
+#include "UringTransport.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "spdlog/spdlog.h"
+
+
+using Clock = std::chrono::steady_clock;
+
+using namespace pid_control;
+
+
+// At most an accept or a receive, and a send, are in flight
+static constexpr unsigned RING_ENTRIES = 8u;
+
+UringTransport::UringTransport(int port) :
+    m_port(port)
+{
+}
+
+UringTransport::~UringTransport()
+{
+    if (m_ringReady)
+    {
+        io_uring_queue_exit(&m_ring);
+    }
+    closeClient();
+    if (m_listener >= 0)
+    {
+        close(m_listener);
+    }
+}
+
+bool UringTransport::Listen()
+{
+    m_listener = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_listener < 0)
+    {
+        spdlog::error("Failed to create a TCP socket: {}", std::strerror(errno));
+        return false;
+    }
+
+    const int reuse = 1;
+    setsockopt(m_listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in address {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(static_cast<uint16_t>(m_port));
+    if (bind(m_listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(m_listener, 1) != 0)
+    {
+        spdlog::error("Failed to listen to port {}: {}", m_port, std::strerror(errno));
+        return false;
+    }
+
+    const int rc = io_uring_queue_init(RING_ENTRIES, &m_ring, 0);
+    if (rc < 0)
+    {
+        spdlog::error("Failed to set up io_uring: {}", std::strerror(-rc));
+        return false;
+    }
+    m_ringReady = true;
+    spdlog::info("Listening to port {} with io_uring", m_port);
+    return true;
+}
+
+void UringTransport::Run()
+{
+    prepareAccept();
+    for (;;)
+    {
+        // Submits the queued send and receive, and waits for a completion, in one system call
+        const int rc = io_uring_submit_and_wait(&m_ring, 1u);
+        if (rc < 0 && rc != -EINTR)
+        {
+            spdlog::error("io_uring wait failed: {}", std::strerror(-rc));
+            return;
+        }
+
+        io_uring_cqe* cqe = nullptr;
+        while (io_uring_peek_cqe(&m_ring, &cqe) == 0)
+        {
+            const auto operation = static_cast<Operation>(reinterpret_cast<uintptr_t>(io_uring_cqe_get_data(cqe)));
+            const int result = cqe->res;
+            io_uring_cqe_seen(&m_ring, cqe);
+
+            switch (operation)
+            {
+            case Operation::ACCEPT: onAccept(result); break;
+            case Operation::RECV:
+                if (not onRecv(result))
+                {
+                    closeClient();
+                    spdlog::info("Disconnected");
+                    prepareAccept();
+                }
+                break;
+            case Operation::SEND: onSend(result); break;
+            }
+        }
+    }
+}
+
+void UringTransport::SendSteer(double steering, double throttle)
+{
+    EncodeSteer(WireProtocol::STRUCT, steering, throttle, m_pending);
+}
+
+void UringTransport::SendReset()
+{
+    EncodeReset(WireProtocol::STRUCT, m_pending);
+}
+
+void UringTransport::onAccept(int result)
+{
+    if (result < 0)
+    {
+        spdlog::error("Failed to accept on port {}: {}", m_port, std::strerror(-result));
+        prepareAccept();
+        return;
+    }
+
+    m_client = result;
+    const int noDelay = 1;
+    setsockopt(m_client, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    m_reader.Reset();
+    m_pending.clear();
+    m_onConnection();
+    prepareRecv();
+}
+
+/*
+* Returns false when the connection is over.
+*/
+bool UringTransport::onRecv(int result)
+{
+    if (result <= 0)
+    {
+        return false;
+    }
+
+    const auto arrival = Clock::now();
+    m_reader.Commit(static_cast<size_t>(result));
+    Telemetry telemetry;
+    bool malformed = false;
+    while (m_reader.Next(telemetry, malformed))
+    {
+        m_onTelemetry(arrival, telemetry);
+    }
+    if (malformed)
+    {
+        spdlog::error("Received a frame that is not STRUCT telemetry, closing the connection");
+        return false;
+    }
+
+    if (not m_sending && m_pending.size() > 0u)
+    {
+        prepareSend();
+    }
+    prepareRecv();
+    return true;
+}
+
+void UringTransport::onSend(int result)
+{
+    m_sending = false;
+    if (result < 0)
+    {
+        // The pending receive notices the connection is gone
+        SPDLOG_DEBUG("Failed to send to port {}: {}", m_port, std::strerror(-result));
+    }
+    else if (static_cast<size_t>(result) < m_inflight.size())
+    {
+        // Short send: the rest goes out first with whatever accumulated meanwhile
+        fmt::memory_buffer rest;
+        rest.append(m_inflight.data() + result, m_inflight.data() + m_inflight.size());
+        rest.append(m_pending.data(), m_pending.data() + m_pending.size());
+        m_pending.clear();
+        m_pending.append(rest.data(), rest.data() + rest.size());
+    }
+
+    if (m_client >= 0 && m_pending.size() > 0u)
+    {
+        prepareSend();
+    }
+}
+
+void UringTransport::prepareAccept()
+{
+    io_uring_sqe* sqe = getSqe();
+    io_uring_prep_accept(sqe, m_listener, nullptr, nullptr, SOCK_CLOEXEC);
+    io_uring_sqe_set_data(sqe, reinterpret_cast<void*>(static_cast<uintptr_t>(Operation::ACCEPT)));
+}
+
+void UringTransport::prepareRecv()
+{
+    io_uring_sqe* sqe = getSqe();
+    io_uring_prep_recv(sqe, m_client, m_reader.WritePointer(), m_reader.WriteSpace(), 0);
+    io_uring_sqe_set_data(sqe, reinterpret_cast<void*>(static_cast<uintptr_t>(Operation::RECV)));
+}
+
+void UringTransport::prepareSend()
+{
+    m_inflight.clear();
+    m_inflight.append(m_pending.data(), m_pending.data() + m_pending.size());
+    m_pending.clear();
+    m_sending = true;
+
+    io_uring_sqe* sqe = getSqe();
+    io_uring_prep_send(sqe, m_client, m_inflight.data(), m_inflight.size(), MSG_NOSIGNAL);
+    io_uring_sqe_set_data(sqe, reinterpret_cast<void*>(static_cast<uintptr_t>(Operation::SEND)));
+}
+
+io_uring_sqe* UringTransport::getSqe()
+{
+    io_uring_sqe* sqe = io_uring_get_sqe(&m_ring);
+    if (sqe == nullptr)
+    {
+        // The submission queue is full: flush it to make room
+        io_uring_submit(&m_ring);
+        sqe = io_uring_get_sqe(&m_ring);
+    }
+    return sqe;
+}
+
+void UringTransport::closeClient()
+{
+    if (m_client >= 0)
+    {
+        close(m_client);
+        m_client = -1;
+    }
+}
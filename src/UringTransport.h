@@ -0,0 +1,61 @@
+#ifndef URING_TRANSPORT_H
+#define URING_TRANSPORT_H
+
+#include <liburing.h>
+
+#include "Protocol.h"
+#include "Transport.h"
+
+
+namespace pid_control
+{
+    /*
+    * TCP server driven by io_uring, with STRUCT frames (see Protocol.h) in both directions. The steering reply of
+    * a tick and the receive of the next one are submitted, and the next completion awaited, in a single system call.
+    * Only built when liburing is available (PID_HAVE_IO_URING).
+    */
+    class UringTransport : public Transport
+    {
+    public:
+        explicit UringTransport(int port);
+        ~UringTransport();
+
+        const char* Name() const override { return "io_uring"; };
+        bool Listen() override;
+        void Run() override;
+        void SendSteer(double steering, double throttle) override;
+        void SendReset() override;
+
+    private:
+        enum class Operation : uint64_t
+        {
+            ACCEPT,
+            RECV,
+            SEND,
+        };
+
+        void onAccept(int result);
+        bool onRecv(int result);
+        void onSend(int result);
+
+        void prepareAccept();
+        void prepareRecv();
+        void prepareSend();
+        io_uring_sqe* getSqe();
+        void closeClient();
+
+        const int m_port;
+        io_uring m_ring {};
+        bool m_ringReady { false };
+        int m_listener { -1 };
+        int m_client { -1 };
+        StructStreamReader m_reader;
+
+        // Commands accumulate in m_pending while one send is in flight from m_inflight, which keeps them in order
+        fmt::memory_buffer m_pending;
+        fmt::memory_buffer m_inflight;
+        bool m_sending { false };
+    };
+}
+
+#endif  // URING_TRANSPORT_H
@@ -0,0 +1,154 @@
+#include "VehicleBatch.h"
+
+#include <cmath>
+
+
+using namespace pid_control;
+
+
+// Same vehicle as VehicleSim
+static constexpr double WHEELBASE = 2.67;
+static constexpr double MAX_STEERING = 25.0 * M_PI / 180.0;
+static constexpr double MAX_ACCELERATION = 10.0;
+static constexpr double DRAG = 0.22;
+static constexpr double MPH_PER_MPS = 2.23694;
+
+VehicleBatch::VehicleBatch(const Track& track, double dt, size_t cars) :
+    m_track(track), m_dt(dt),
+    m_x(cars), m_y(cars), m_cos(cars), m_sin(cars), m_speed(cars), m_cte(cars), m_segment(cars),
+    m_kp(cars), m_ki(cars), m_kd(cars), m_totalError(cars), m_prevError(cars),
+    m_alive(cars), m_ticks(cars), m_cteSum(cars)
+{}
+
+void VehicleBatch::SetGains(size_t car, double kp, double ki, double kd)
+{
+    m_kp[car] = kp;
+    m_ki[car] = ki;
+    m_kd[car] = kd;
+}
+
+void VehicleBatch::reset()
+{
+    const Point& start = m_track.Start(0u);
+    const double heading = m_track.Heading(0u);
+    size_t segment = 0u;
+    const double cte = m_track.Cte(start.x, start.y, segment);
+
+    for (size_t i = 0; i < Size(); ++i)
+    {
+        m_x[i] = start.x;
+        m_y[i] = start.y;
+        m_cos[i] = std::cos(heading);
+        m_sin[i] = std::sin(heading);
+        m_speed[i] = 0.0;
+        m_cte[i] = cte;
+        m_segment[i] = segment;
+        m_totalError[i] = 0.0;
+        m_prevError[i] = 0.0;
+        m_alive[i] = 1.0;
+        m_ticks[i] = 0.0;
+        m_cteSum[i] = 0.0;
+    }
+}
+
+void VehicleBatch::step(double throttle, const EpisodeLimits& limits, unsigned tick)
+{
+    const size_t n = Size();
+    double* __restrict x = m_x.data();
+    double* __restrict y = m_y.data();
+    double* __restrict c = m_cos.data();
+    double* __restrict s = m_sin.data();
+    double* __restrict v = m_speed.data();
+    const double* __restrict cte = m_cte.data();
+    const double* __restrict kp = m_kp.data();
+    const double* __restrict ki = m_ki.data();
+    const double* __restrict kd = m_kd.data();
+    double* __restrict total = m_totalError.data();
+    double* __restrict prev = m_prevError.data();
+    double* __restrict alive = m_alive.data();
+    double* __restrict ticks = m_ticks.data();
+    double* __restrict cteSum = m_cteSum.data();
+
+    const double checking = tick >= limits.graceTicks ? 1.0 : 0.0;
+    const double dt = m_dt;
+
+    // Termination, control and kinematics, all branch-free so the loop vectorizes
+    for (size_t i = 0; i < n; ++i)
+    {
+        const double absCte = std::fabs(cte[i]);
+        const double failed = (absCte > limits.maxCte || v[i] * MPH_PER_MPS < limits.minSpeed) ? checking : 0.0;
+        const double a = alive[i] * (1.0 - failed);
+        alive[i] = a;
+        ticks[i] += a;
+        cteSum[i] += a * absCte;
+
+        // PID::Apply
+        total[i] += cte[i];
+        double u = -kp[i] * cte[i] - ki[i] * total[i] - kd[i] * (cte[i] - prev[i]);
+        prev[i] = cte[i];
+        u = u < -1.0 ? -1.0 : (u > 1.0 ? 1.0 : u);
+
+        // tan of the wheel angle, Taylor series to x^7: < 0.1% error within +-25 degrees
+        const double delta = -u * MAX_STEERING;
+        const double d2 = delta * delta;
+        const double tanDelta = delta * (1.0 + d2 * (1.0 / 3.0 + d2 * (2.0 / 15.0 + d2 * (17.0 / 315.0))));
+
+        // Rotate the heading vector by the yaw change of this tick, small angle series to 5th order
+        const double yaw = a * v[i] / WHEELBASE * tanDelta * dt;
+        const double y2 = yaw * yaw;
+        const double cosYaw = 1.0 - y2 * (0.5 - y2 * (1.0 / 24.0));
+        const double sinYaw = yaw * (1.0 - y2 * (1.0 / 6.0 - y2 * (1.0 / 120.0)));
+
+        x[i] += a * v[i] * c[i] * dt;
+        y[i] += a * v[i] * s[i] * dt;
+        const double nc = c[i] * cosYaw - s[i] * sinYaw;
+        const double ns = s[i] * cosYaw + c[i] * sinYaw;
+        const double norm = 1.0 / std::sqrt(nc * nc + ns * ns);
+        c[i] = nc * norm;
+        s[i] = ns * norm;
+
+        const double speed = v[i] + a * (MAX_ACCELERATION * throttle - DRAG * v[i]) * dt;
+        v[i] = speed < 0.0 ? 0.0 : speed;
+    }
+
+    // Geometry, per car
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (m_alive[i] > 0.0)
+        {
+            m_cte[i] = m_track.Cte(m_x[i], m_y[i], m_segment[i]);
+        }
+    }
+}
+
+size_t VehicleBatch::Run(double throttle, const EpisodeLimits& limits)
+{
+    reset();
+
+    size_t vehicleTicks = 0u;
+    for (unsigned tick = 0u; tick < limits.maxTicks; ++tick)
+    {
+        step(throttle, limits, tick);
+
+        size_t alive = 0u;
+        for (size_t i = 0; i < Size(); ++i)
+        {
+            alive += m_alive[i] > 0.0;
+        }
+        vehicleTicks += alive;
+        if (alive == 0u)
+        {
+            break;
+        }
+    }
+    return vehicleTicks;
+}
+
+EpisodeResult VehicleBatch::Result(size_t car, const EpisodeLimits& limits) const
+{
+    EpisodeResult result;
+    result.ticks = static_cast<unsigned>(m_ticks[car]);
+    result.meanAbsCte = result.ticks > 0u ? m_cteSum[car] / result.ticks : 0.0;
+    result.failed = result.ticks < limits.maxTicks;
+    return result;
+}
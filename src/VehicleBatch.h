@@ -0,0 +1,67 @@
+#ifndef VEHICLE_BATCH_H
+#define VEHICLE_BATCH_H
+
+#include <cstddef>
+#include <vector>
+
+#include "Episode.h"
+#include "Track.h"
+
+
+namespace pid_control
+{
+    /*
+    * Many independent cars on the same Track, each driven by its own PID gains, stepped in lockstep.
+    * The state is kept as structure-of-arrays and the control, kinematics and termination passes are
+    * branch-free loops over it that the compiler vectorizes; only the CTE lookup is per car.
+    * The dynamics match VehicleSim, with the trigonometry replaced by polynomials that are accurate
+    * over the steering range and per-tick heading changes.
+    */
+    class VehicleBatch
+    {
+    public:
+        VehicleBatch(const Track& track, double dt, size_t cars);
+
+        size_t Size() const { return m_x.size(); };
+
+        void SetGains(size_t car, double kp, double ki, double kd);
+
+        /*
+        * Runs every car from the start of the track until all of them ended their episode.
+        * Returns the number of vehicle-ticks simulated.
+        */
+        size_t Run(double throttle, const EpisodeLimits& limits);
+
+        EpisodeResult Result(size_t car, const EpisodeLimits& limits) const;
+
+    private:
+        void reset();
+        void step(double throttle, const EpisodeLimits& limits, unsigned tick);
+
+        const Track& m_track;
+        const double m_dt { 0.0 };
+
+        // Vehicle state
+        std::vector<double> m_x;
+        std::vector<double> m_y;
+        std::vector<double> m_cos;      // Heading as a unit vector
+        std::vector<double> m_sin;
+        std::vector<double> m_speed;    // m/s
+        std::vector<double> m_cte;
+        std::vector<size_t> m_segment;
+
+        // Controller state
+        std::vector<double> m_kp;
+        std::vector<double> m_ki;
+        std::vector<double> m_kd;
+        std::vector<double> m_totalError;
+        std::vector<double> m_prevError;
+
+        // Episode bookkeeping; `alive` is 1.0 or 0.0 so it can scale updates instead of branching on them
+        std::vector<double> m_alive;
+        std::vector<double> m_ticks;
+        std::vector<double> m_cteSum;
+    };
+}
+
+#endif  // VEHICLE_BATCH_H
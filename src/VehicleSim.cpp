@@ -0,0 +1,91 @@
+#include "VehicleSim.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+
+using namespace pid_control;
+
+
+static constexpr double WHEELBASE = 2.67;                       // m
+static constexpr double MAX_STEERING = 25.0 * M_PI / 180.0;     // rad
+static constexpr double MAX_ACCELERATION = 10.0;                // m/s^2 at full throttle
+static constexpr double DRAG = 0.22;                            // 1/s, settles at ~30 mph with 0.3 throttle
+static constexpr double MPH_PER_MPS = 2.23694;
+
+VehicleSim::VehicleSim(const Track& track, double dt, const NoiseConfig& noise, uint64_t seed) :
+    m_track(track), m_dt(dt), m_noise(noise), m_seed(seed)
+{
+    // Per-episode randomization, fixed for the lifetime of the sim so snapshots stay valid
+    const unsigned maxDelay = std::min(noise.maxDelayTicks, MAX_ACTUATION_DELAY_TICKS);
+    m_delayTicks = static_cast<unsigned>(NoiseUniform(seed, NoiseStream::DELAY, 0u) * (maxDelay + 1u));
+    m_steeringScale = 1.0 + noise.dynamicsSpread * (2.0 * NoiseUniform(seed, NoiseStream::STEERING, 0u) - 1.0);
+    m_dragScale = 1.0 + noise.dynamicsSpread * (2.0 * NoiseUniform(seed, NoiseStream::DRAG, 0u) - 1.0);
+
+    Reset();
+}
+
+void VehicleSim::Reset(size_t segment)
+{
+    const Point& start = m_track.Start(segment);
+    m_state = VehicleState();
+    m_state.x = start.x;
+    m_state.y = start.y;
+    m_state.heading = m_track.Heading(segment);
+    m_state.segment = segment;
+    updateCte();
+}
+
+void VehicleSim::Restore(const VehicleState& state)
+{
+    m_state = state;
+    updateCte();
+}
+
+double VehicleSim::SpeedMph() const
+{
+    if (m_noise.speedStddev <= 0.0)
+    {
+        return TrueSpeedMph();
+    }
+    return TrueSpeedMph() + m_noise.speedStddev * NoiseGaussian(m_seed, NoiseStream::SPEED, m_state.tick);
+}
+
+double VehicleSim::TrueSpeedMph() const
+{
+    return m_state.speed * MPH_PER_MPS;
+}
+
+void VehicleSim::Step(double steering, double throttle)
+{
+    steering = steering < -1.0 ? -1.0 : (steering > 1.0 ? 1.0 : steering);
+
+    if (m_delayTicks > 0u)
+    {
+        // The slot for this tick holds the command sent m_delayTicks ago
+        double& pending = m_state.pendingSteering[m_state.tick % m_delayTicks];
+        std::swap(steering, pending);
+    }
+
+    // Positive steering turns right, i.e. clockwise
+    const double yawRate = m_state.speed / WHEELBASE * std::tan(-steering * m_steeringScale * MAX_STEERING);
+    m_state.x += m_state.speed * std::cos(m_state.heading) * m_dt;
+    m_state.y += m_state.speed * std::sin(m_state.heading) * m_dt;
+    m_state.heading += yawRate * m_dt;
+    m_state.speed += (MAX_ACCELERATION * throttle - DRAG * m_dragScale * m_state.speed) * m_dt;
+    m_state.speed = m_state.speed < 0.0 ? 0.0 : m_state.speed;
+    m_state.tick++;
+
+    updateCte();
+}
+
+void VehicleSim::updateCte()
+{
+    m_cte = m_track.Cte(m_state.x, m_state.y, m_state.segment);
+    m_measuredCte = m_cte;
+    if (m_noise.cteStddev > 0.0)
+    {
+        m_measuredCte += m_noise.cteStddev * NoiseGaussian(m_seed, NoiseStream::CTE, m_state.tick);
+    }
+}
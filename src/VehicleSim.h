@@ -0,0 +1,77 @@
+#ifndef VEHICLE_SIM_H
+#define VEHICLE_SIM_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "Noise.h"
+#include "Track.h"
+
+
+namespace pid_control
+{
+    static constexpr unsigned MAX_ACTUATION_DELAY_TICKS = 16u;
+
+    /*
+    * Complete state of a simulated vehicle. Plain data, so snapshots are cheap to take, copy and restore.
+    */
+    struct VehicleState
+    {
+        double x { 0.0 };
+        double y { 0.0 };
+        double heading { 0.0 };   // Radians, counter-clockwise from the x axis
+        double speed { 0.0 };     // m/s
+        size_t segment { 0u };    // Track segment the CTE was last measured to
+        unsigned tick { 0u };     // Ticks since the episode start
+        std::array<double, MAX_ACTUATION_DELAY_TICKS> pendingSteering {};  // Commands not yet applied, by tick
+    };
+
+    /*
+    * Headless stand-in for the simulator: a kinematic bicycle model driving on a Track, stepped at a fixed tick.
+    * Steering and throttle follow the simulator's conventions: steering in [-1, 1] maps to +-25 degrees
+    * with positive steering turning right, and speed is reported in mph.
+    * With a NoiseConfig, Cte() and SpeedMph() are noisy measurements, steering takes effect some ticks late,
+    * and the car's steering response and drag are perturbed; all of it is drawn from `seed`.
+    * TrueCte() and TrueSpeedMph() stay noise-free for scoring.
+    */
+    class VehicleSim
+    {
+    public:
+        VehicleSim(const Track& track, double dt, const NoiseConfig& noise = NoiseConfig(), uint64_t seed = 0u);
+
+        /*
+        * Place the car at rest on the centerline at the start of `segment`, facing along the track.
+        */
+        void Reset(size_t segment = 0u);
+
+        void Step(double steering, double throttle);
+
+        double Cte() const { return m_measuredCte; };
+        double SpeedMph() const;
+        double TrueCte() const { return m_cte; };
+        double TrueSpeedMph() const;
+        unsigned Tick() const { return m_state.tick; };
+
+        VehicleState Snapshot() const { return m_state; };
+        void Restore(const VehicleState& state);
+
+    private:
+        void updateCte();
+
+        const Track& m_track;
+        const double m_dt { 0.0 };
+
+        const NoiseConfig m_noise;
+        const uint64_t m_seed { 0u };
+        unsigned m_delayTicks { 0u };
+        double m_steeringScale { 1.0 };
+        double m_dragScale { 1.0 };
+
+        VehicleState m_state;
+        double m_cte { 0.0 };
+        double m_measuredCte { 0.0 };
+    };
+}
+
+#endif  // VEHICLE_SIM_H
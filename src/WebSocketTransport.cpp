@@ -0,0 +1,198 @@
+#include "WebSocketTransport.h"
+
+#include <algorithm>
+#include <exception>
+
+#include "spdlog/spdlog.h"
+
+#include "FastJson.h"
+
+
+// for convenience
+using std::string;
+using Clock = std::chrono::steady_clock;
+
+using namespace pid_control;
+
+
+static constexpr size_t JSON_ARENA_BYTES = 64u * 1024u;
+
+WebSocketTransport::WebSocketTransport(int port, std::vector<WireProtocol> allowedProtocols) :
+    m_port(port), m_allowedProtocols(std::move(allowedProtocols)),
+    m_socketIo([this](const char* data, size_t length) { sendText(data, length); }), m_arena(JSON_ARENA_BYTES)
+{
+    m_socketIo.On("telemetry", [this](const SocketIoEvent& event) { onTelemetryEvent(event); });
+    m_socketIo.On("hello", [this](const SocketIoEvent& event) { onHelloEvent(event); });
+
+    m_hub.onMessage([this](uWS::WebSocket<uWS::SERVER> ws, char *data, size_t length, uWS::OpCode opCode)
+    {
+        onMessage(ws, data, length, opCode);
+    });
+
+    m_hub.onConnection([this](uWS::WebSocket<uWS::SERVER> ws, uWS::HttpRequest req)
+    {
+        onConnection(ws);
+    });
+
+    m_hub.onDisconnection([this](uWS::WebSocket<uWS::SERVER> ws, int code, char *message, size_t length)
+    {
+        onDisconnection(ws);
+    });
+}
+
+bool WebSocketTransport::Listen()
+{
+    if (not m_hub.listen(m_port))
+    {
+        spdlog::error("Failed to listen to port");
+        return false;
+    }
+    spdlog::info("Listening to port {}", m_port);
+    return true;
+}
+
+void WebSocketTransport::Run()
+{
+    // Telemetry is parsed into the arena, the handlers run on this thread
+    Arena::SetCurrent(&m_arena);
+    m_hub.run();
+    Arena::SetCurrent(nullptr);
+}
+
+void WebSocketTransport::SendSteer(double steering, double throttle)
+{
+    m_message.clear();
+    EncodeSteer(m_protocol, steering, throttle, m_message);
+    SPDLOG_DEBUG("Message: {} bytes of {}", m_message.size(), ProtocolName(m_protocol));
+    send(m_message);
+}
+
+void WebSocketTransport::SendReset()
+{
+    m_message.clear();
+    EncodeReset(m_protocol, m_message);
+    send(m_message);
+}
+
+void WebSocketTransport::send(const fmt::memory_buffer& message)
+{
+    if (m_socket)
+    {
+        m_socket->send(message.data(), message.size(),
+                       m_protocol == WireProtocol::TEXT ? uWS::OpCode::TEXT : uWS::OpCode::BINARY);
+    }
+}
+
+void WebSocketTransport::sendText(const char* data, size_t length)
+{
+    if (m_socket)
+    {
+        m_socket->send(data, length, uWS::OpCode::TEXT);
+    }
+}
+
+void WebSocketTransport::onConnection(uWS::WebSocket<uWS::SERVER> ws)
+{
+    // Every connection starts with the text protocol, whatever the previous one negotiated
+    m_socket.reset(new uWS::WebSocket<uWS::SERVER>(ws));
+    m_protocol = WireProtocol::TEXT;
+    m_onConnection();
+}
+
+void WebSocketTransport::onDisconnection(uWS::WebSocket<uWS::SERVER> ws)
+{
+    if (m_socket && *m_socket == ws)
+    {
+        m_socket.reset();
+        m_protocol = WireProtocol::TEXT;
+    }
+    ws.close();
+    spdlog::info("Disconnected");
+}
+
+void WebSocketTransport::onMessage(uWS::WebSocket<uWS::SERVER> ws, char* data, size_t length, uWS::OpCode opCode)
+{
+    m_arrival = Clock::now();
+    if (not m_socket || not (*m_socket == ws))
+    {
+        SPDLOG_DEBUG("Ignoring a message from a replaced connection");
+        return;
+    }
+
+    // Everything parsed from the frame lives in the arena until the end of the tick
+    ArenaResetGuard arenaReset(m_arena);
+
+    if (opCode == uWS::OpCode::BINARY)
+    {
+        Telemetry telemetry;
+        if (m_protocol != WireProtocol::TEXT &&
+            DecodeTelemetry(m_protocol, data, length, telemetry))
+        {
+            m_onTelemetry(m_arrival, telemetry);
+        }
+        return;
+    }
+
+    m_socketIo.Receive(data, length);
+}
+
+void WebSocketTransport::onTelemetryEvent(const SocketIoEvent& event)
+{
+    if (event.argumentCount == 0u || event.arguments[0].IsNull())
+    {
+        // Manual driving
+        static const char manual[] = "42[\"manual\",{}]";
+        sendText(manual, sizeof(manual) - 1u);
+        return;
+    }
+
+    // The data JSON object, whose values are numeric strings
+    Telemetry telemetry;
+    try
+    {
+        const JsonSpan& argument = event.arguments[0];
+        auto data = fast_json::parse(argument.data, argument.data + argument.length);
+        telemetry.cte = std::stod(data["cte"].get_ref<const string&>());
+        telemetry.speed = std::stod(data["speed"].get_ref<const string&>());
+        telemetry.steeringAngle = std::stod(data["steering_angle"].get_ref<const string&>());
+    }
+    catch (const std::exception&)
+    {
+        // json.hpp and stod report malformed input with exceptions
+        spdlog::warn("Ignoring malformed telemetry");
+        return;
+    }
+
+    m_onTelemetry(m_arrival, telemetry);
+}
+
+void WebSocketTransport::onHelloEvent(const SocketIoEvent& event)
+{
+    // The client lists the binary protocols it speaks, preferred first; pick the first one allowed here
+    m_protocol = WireProtocol::TEXT;
+    try
+    {
+        const JsonSpan& argument = event.argumentCount > 0u ? event.arguments[0] : JsonSpan();
+        auto data = fast_json::parse(argument.data, argument.data + argument.length);
+        const auto& offered = data["protocols"];
+        for (size_t i = 0u; offered.is_array() && i < offered.size() && m_protocol == WireProtocol::TEXT; ++i)
+        {
+            WireProtocol candidate;
+            if (offered[i].is_string() && ParseProtocolName(offered[i].get_ref<const string&>(), candidate) &&
+                std::find(m_allowedProtocols.begin(), m_allowedProtocols.end(), candidate) != m_allowedProtocols.end())
+            {
+                m_protocol = candidate;
+            }
+        }
+    }
+    catch (const std::exception&)
+    {
+        // Not an offer, answered with the text protocol
+    }
+
+    // The answer is the last text frame, everything after it uses the chosen protocol
+    m_message.clear();
+    fmt::format_to(m_message, "42[\"hello\",{{\"protocol\":\"{}\"}}]", ProtocolName(m_protocol));
+    sendText(m_message.data(), m_message.size());
+    spdlog::info("Using the {} protocol", ProtocolName(m_protocol));
+}
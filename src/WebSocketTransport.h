@@ -0,0 +1,62 @@
+#ifndef WEB_SOCKET_TRANSPORT_H
+#define WEB_SOCKET_TRANSPORT_H
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include <uWS/uWS.h>
+
+#include "Arena.h"
+#include "Protocol.h"
+#include "SocketIo.h"
+#include "Transport.h"
+
+
+namespace pid_control
+{
+    /*
+    * The simulator's socket.io over WebSocket, served with uWebSockets. Clients may switch the connection to
+    * one of `allowedProtocols` with a hello event (see Protocol.h).
+    */
+    class WebSocketTransport : public Transport
+    {
+    public:
+        WebSocketTransport(int port, std::vector<WireProtocol> allowedProtocols);
+
+        const char* Name() const override { return "websocket"; };
+        bool Listen() override;
+        void Run() override;
+        void SendSteer(double steering, double throttle) override;
+        void SendReset() override;
+
+    private:
+        void onConnection(uWS::WebSocket<uWS::SERVER> ws);
+        void onDisconnection(uWS::WebSocket<uWS::SERVER> ws);
+        void onMessage(uWS::WebSocket<uWS::SERVER> ws, char* data, size_t length, uWS::OpCode opCode);
+        void onTelemetryEvent(const SocketIoEvent& event);
+        void onHelloEvent(const SocketIoEvent& event);
+        void send(const fmt::memory_buffer& message);
+        void sendText(const char* data, size_t length);
+
+        uWS::Hub m_hub;
+        const int m_port;
+        const std::vector<WireProtocol> m_allowedProtocols;
+
+        // A copy of uWS's handle of the connected simulator, null between connections. A new connection replaces it,
+        // and messages still arriving from the replaced one are ignored
+        std::unique_ptr<uWS::WebSocket<uWS::SERVER>> m_socket;
+        // The wire format of the current connection, TEXT unless the client negotiated a binary one
+        WireProtocol m_protocol { WireProtocol::TEXT };
+        // When the message being handled arrived
+        std::chrono::steady_clock::time_point m_arrival;
+
+        SocketIo m_socketIo;
+
+        // Reserved up front so that steady state ticks do not allocate; parsed frames live in the arena
+        Arena m_arena;
+        fmt::memory_buffer m_message;
+    };
+}
+
+#endif  // WEB_SOCKET_TRANSPORT_H
@@ -0,0 +1,128 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+
+#include "Arena.h"
+#include "FastJson.h"
+#include "LatencyHistogram.h"
+
+using Clock = std::chrono::steady_clock;
+
+using namespace pid_control;
+
+
+static constexpr unsigned DEFAULT_FRAMES = 100000u;
+// The same size as WebSocketTransport's arena
+static constexpr size_t ARENA_BYTES = 64u * 1024u;
+// The data object of a simulator telemetry frame, the part WebSocketTransport parses
+static constexpr char TELEMETRY[] =
+    "{\"cte\":\"0.7598\",\"speed\":\"28.3201\",\"steering_angle\":\"-1.8457\",\"throttle\":\"0.3000\"}";
+
+// Heap allocations of the whole program, counted by the replaced operator new
+static uint64_t allocations = 0u;
+
+void* operator new(size_t bytes)
+{
+    allocations++;
+    if (void* pointer = std::malloc(bytes == 0u ? 1u : bytes))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+static uint64_t nanosBetween(Clock::time_point from, Clock::time_point to)
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count());
+}
+
+/*
+* Parses the frame and reads its fields the way WebSocketTransport does.
+*/
+template<typename Json>
+static double parseTelemetry(const char* text, size_t length)
+{
+    auto data = Json::parse(text, text + length);
+    return std::stod(data["cte"].template get_ref<const std::string&>()) +
+           std::stod(data["speed"].template get_ref<const std::string&>()) +
+           std::stod(data["steering_angle"].template get_ref<const std::string&>());
+}
+
+/*
+* The latency and heap allocations of parsing `frames` telemetry frames, into `arena` when it is given.
+*/
+template<typename Json>
+static void measure(const char* name, unsigned frames, Arena* arena)
+{
+    const size_t length = sizeof(TELEMETRY) - 1u;
+    // Parsed into a buffer like a received frame, so the parser cannot see a literal
+    const std::string frame(TELEMETRY, length);
+    Arena::SetCurrent(arena);
+
+    LatencyHistogram latency;
+    // Keeps the parses from being optimized away
+    volatile double sink = 0.0;
+    const uint64_t before = allocations;
+    for (unsigned i = 0u; i < frames; ++i)
+    {
+        const auto start = Clock::now();
+        if (arena != nullptr)
+        {
+            ArenaResetGuard reset(*arena);
+            sink = sink + parseTelemetry<Json>(frame.data(), length);
+        }
+        else
+        {
+            sink = sink + parseTelemetry<Json>(frame.data(), length);
+        }
+        latency.Record(nanosBetween(start, Clock::now()));
+    }
+    const uint64_t allocated = allocations - before;
+
+    Arena::SetCurrent(nullptr);
+    std::printf("%-9s %.2f allocations/frame, %s\n", name, static_cast<double>(allocated) / frames,
+                latency.Summary().c_str());
+    if (arena != nullptr)
+    {
+        std::printf("%-9s arena high water %zu bytes, %zu overflows\n", name, arena->HighWater(), arena->Overflows());
+    }
+}
+
+/*
+* Compares parsing a telemetry frame with json and with the arena-allocated fast_json, counting the heap
+* allocations of each through a replaced operator new, e.g.
+*   pid_json_bench 100000
+*/
+int main(int argc, char* argv[])
+{
+    if (argc > 2)
+    {
+        std::fprintf(stderr, "Usage: %s [FRAMES]\n", argv[0]);
+        return -1;
+    }
+    const unsigned frames = argc == 2 ? static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10)) : DEFAULT_FRAMES;
+    if (frames == 0u)
+    {
+        std::fprintf(stderr, "FRAMES must be positive\n");
+        return -1;
+    }
+
+    Arena arena(ARENA_BYTES);
+    measure<nlohmann::json>("json", frames, nullptr);
+    measure<fast_json>("fast_json", frames, &arena);
+    return 0;
+}
@@ -0,0 +1,234 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "spdlog/spdlog.h"
+#include "spdlog/async.h"
+#include "spdlog/details/mpmc_blocking_q.h"
+#include "spdlog/details/mpmc_lockfree_q.h"
+#include "spdlog/details/null_mutex.h"
+#include "spdlog/sinks/base_sink.h"
+#include "spdlog/sinks/null_sink.h"
+
+#include "LatencyHistogram.h"
+
+using Clock = std::chrono::steady_clock;
+
+using namespace pid_control;
+
+
+static constexpr unsigned DEFAULT_MESSAGES = 200000u;
+// The same size as pid's asynchronous logger queue
+static constexpr size_t QUEUE_SIZE = 8192u;
+static constexpr unsigned OTHER_THREADS[] = {0u, 1u, 3u, 7u};
+static constexpr auto DEQUEUE_TIMEOUT = std::chrono::milliseconds(10);
+// Messages logged one at a time after an idle period, and the pause before each
+static constexpr unsigned IDLE_MESSAGES = 1000u;
+static constexpr auto IDLE_PAUSE = std::chrono::milliseconds(1);
+
+#ifdef SPDLOG_LOCK_FREE_QUEUE
+static constexpr const char* THREAD_POOL_QUEUE = "lock-free";
+#else
+static constexpr const char* THREAD_POOL_QUEUE = "mutex";
+#endif
+
+static uint64_t nanosBetween(Clock::time_point from, Clock::time_point to)
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count());
+}
+
+/*
+* About the size of a formatted 'CTE/Steering' message in spdlog's async_msg.
+*/
+struct Message
+{
+    std::array<char, 256> text;
+};
+
+/*
+* Enqueue latency of one thread while `otherThreads` threads enqueue in a tight loop and one worker drains the queue,
+* like the control loop logging with --async-log. Messages are enqueued without waiting, as pid does.
+*/
+template<typename Queue>
+static LatencyHistogram measure(unsigned messages, unsigned otherThreads)
+{
+    Queue queue(QUEUE_SIZE);
+    std::atomic<bool> running { true };
+
+    std::thread worker([&queue, &running]
+    {
+        Message message;
+        while (running.load(std::memory_order_relaxed))
+        {
+            queue.dequeue_for(message, DEQUEUE_TIMEOUT);
+        }
+    });
+
+    std::vector<std::thread> others;
+    for (unsigned i = 0u; i < otherThreads; ++i)
+    {
+        others.emplace_back([&queue, &running]
+        {
+            while (running.load(std::memory_order_relaxed))
+            {
+                queue.enqueue_nowait(Message());
+            }
+        });
+    }
+
+    LatencyHistogram latency;
+    for (unsigned i = 0u; i < messages; ++i)
+    {
+        Message message;
+        message.text[0] = static_cast<char>(i);
+        const auto start = Clock::now();
+        queue.enqueue_nowait(std::move(message));
+        latency.Record(nanosBetween(start, Clock::now()));
+    }
+
+    running.store(false);
+    for (auto& other : others)
+    {
+        other.join();
+    }
+    worker.join();
+    return latency;
+}
+
+/*
+* The per-tick message of pid's control loop.
+*/
+static void logTick(spdlog::logger& logger, unsigned tick)
+{
+    const double cte = 0.5 * std::sin(0.01 * tick);
+    logger.info("CTE: {}, Predicted CTE: {}, Delay: {}s, Steering Value: {}, Speed: {}",
+                cte, 1.1 * cte, 0.012, -0.3 * cte, 30.0);
+}
+
+/*
+* The latency of one call to an async_logger on spdlog's thread pool, as --async-log sets it up: formatting into
+* the async_msg, moving it into the queue slot and waking the worker, which writes to a null sink.
+*/
+static LatencyHistogram measureLogger(unsigned messages, unsigned otherThreads)
+{
+    auto pool = std::make_shared<spdlog::details::thread_pool>(QUEUE_SIZE, 1u);
+    // Posts messages with shared_from_this, so it must be owned by a shared_ptr
+    auto logger = std::make_shared<spdlog::async_logger>("bench", std::make_shared<spdlog::sinks::null_sink_mt>(),
+                                                         pool, spdlog::async_overflow_policy::overrun_oldest);
+    std::atomic<bool> running { true };
+
+    std::vector<std::thread> others;
+    for (unsigned i = 0u; i < otherThreads; ++i)
+    {
+        others.emplace_back([&logger, &running]
+        {
+            for (unsigned tick = 0u; running.load(std::memory_order_relaxed); ++tick)
+            {
+                logTick(*logger, tick);
+            }
+        });
+    }
+
+    LatencyHistogram latency;
+    for (unsigned i = 0u; i < messages; ++i)
+    {
+        const auto start = Clock::now();
+        logTick(*logger, i);
+        latency.Record(nanosBetween(start, Clock::now()));
+    }
+
+    running.store(false);
+    for (auto& other : others)
+    {
+        other.join();
+    }
+    return latency;
+}
+
+/*
+* Counts the messages the worker delivered.
+*/
+class CountingSink : public spdlog::sinks::base_sink<spdlog::details::null_mutex>
+{
+public:
+    uint64_t Delivered() const { return m_delivered.load(std::memory_order_acquire); };
+
+protected:
+    void sink_it_(const spdlog::details::log_msg&) override { m_delivered.fetch_add(1u, std::memory_order_release); };
+    void flush_() override {};
+
+private:
+    std::atomic<uint64_t> m_delivered { 0u };
+};
+
+/*
+* The time from logging a message to its delivery by a worker that was idle, which includes waking it.
+*/
+static LatencyHistogram measureDelivery(unsigned messages)
+{
+    auto pool = std::make_shared<spdlog::details::thread_pool>(QUEUE_SIZE, 1u);
+    auto sink = std::make_shared<CountingSink>();
+    auto logger = std::make_shared<spdlog::async_logger>("bench", sink, pool, spdlog::async_overflow_policy::overrun_oldest);
+
+    LatencyHistogram latency;
+    for (unsigned i = 0u; i < messages; ++i)
+    {
+        std::this_thread::sleep_for(IDLE_PAUSE);
+        const auto start = Clock::now();
+        logTick(*logger, i);
+        while (sink->Delivered() <= i)
+        {
+            std::this_thread::yield();
+        }
+        latency.Record(nanosBetween(start, Clock::now()));
+    }
+    return latency;
+}
+
+/*
+* Compares the enqueue latency of spdlog's mutex based queue and the lock-free one selected by
+* PID_LOCK_FREE_LOG_QUEUE, e.g.
+*   pid_log_queue_bench queue 200000     (the two queues with a message-sized item)
+*   pid_log_queue_bench logger 200000    (an async_logger on the thread pool, mutex queue)
+*   pid_log_queue_bench_lock_free logger (the same on the lock-free queue)
+* The logger mode also reports the delivery latency of messages logged while the worker is idle.
+*/
+int main(int argc, char* argv[])
+{
+    const bool loggerMode = argc >= 2 && std::strcmp(argv[1], "logger") == 0;
+    if (argc > 3 || (argc >= 2 && not loggerMode && std::strcmp(argv[1], "queue") != 0))
+    {
+        std::fprintf(stderr, "Usage: %s [queue|logger] [MESSAGES]\n", argv[0]);
+        return -1;
+    }
+    const unsigned messages = argc == 3 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : DEFAULT_MESSAGES;
+
+    if (loggerMode)
+    {
+        for (unsigned otherThreads : OTHER_THREADS)
+        {
+            std::printf("%u other threads, %s queue logger: %s\n", otherThreads, THREAD_POOL_QUEUE,
+                        measureLogger(messages, otherThreads).Summary().c_str());
+        }
+        std::printf("delivery after idle, %s queue: %s\n", THREAD_POOL_QUEUE,
+                    measureDelivery(IDLE_MESSAGES).Summary().c_str());
+        return 0;
+    }
+
+    for (unsigned otherThreads : OTHER_THREADS)
+    {
+        const auto mutex = measure<spdlog::details::mpmc_blocking_queue<Message>>(messages, otherThreads);
+        const auto lockFree = measure<spdlog::details::mpmc_lockfree_queue<Message>>(messages, otherThreads);
+        std::printf("%u other threads, mutex:     %s\n", otherThreads, mutex.Summary().c_str());
+        std::printf("%u other threads, lock-free: %s\n", otherThreads, lockFree.Summary().c_str());
+    }
+    return 0;
+}
@@ -1,19 +1,37 @@
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <iostream>
 #include <limits>
 #include <math.h>
+#include <memory>
 #include <string>
+#include <vector>
 
-#include <uWS/uWS.h>
-#include "json.hpp"
 #include "spdlog/spdlog.h"
-
-#include "Twiddle.h"
+#include "spdlog/async.h"
+#include "spdlog/sinks/gzip_rotating_file_sink.h"
+#include "spdlog/sinks/stdout_color_sinks.h"
+#include "spdlog/sinks/throttled_sink.h"
+
+#include "AdaptiveTuner.h"
+#include "BayesOpt.h"
+#include "DeadlineWatchdog.h"
+#include "DelayCompensator.h"
+#include "GainSchedule.h"
+#include "Hyperband.h"
+#include "LatencyHistogram.h"
+#include "Options.h"
 #include "PID.h"
+#include "RealTime.h"
+#include "RelayAutoTune.h"
+#include "TraceLog.h"
+#include "Transport.h"
+#include "Twiddle.h"
 
 // for convenience
-using nlohmann::json;
 using std::string;
+using Clock = std::chrono::steady_clock;
 
 using namespace pid_control;
 
@@ -23,25 +41,6 @@ constexpr double pi() { return M_PI; }
 double deg2rad(double x) { return x * pi() / 180; }
 double rad2deg(double x) { return x * 180 / pi(); }
 
-// Checks if the SocketIO event has JSON data.
-// If there is data the JSON object in string format will be returned,
-// else the empty string "" will be returned.
-string hasData(string s)
-{
-    auto found_null = s.find("null");
-    auto b1 = s.find_first_of("[");
-    auto b2 = s.find_last_of("]");
-    if (found_null != string::npos)
-    {
-        return "";
-    }
-    else if (b1 != string::npos && b2 != string::npos)
-    {
-        return s.substr(b1, b2 - b1 + 1);
-    }
-    return "";
-}
-
 // Twiddle configuration
 static constexpr double TWIDDLE_TOLERANCE = 0.02;
 
@@ -50,146 +49,487 @@ static constexpr double MAX_ALLOWED_CTE = 2.5;
 static constexpr double MIN_ALLOWED_SPEED = 5.0;
 static constexpr unsigned TERMINATE_AFTER_N_TICKS = 4000u;
 
-int main()
+// Bayesian optimization searches kp, ki and kd within [0, MAX_TUNED_GAINS]
+static const std::array<double, 3> MAX_TUNED_GAINS {{ 1.0, 0.01, 2.0 }};
+
+// Each Hyperband rung keeps the best 1/HYPERBAND_ETA of its candidates
+static constexpr unsigned HYPERBAND_ETA = 3u;
+
+// Relay auto-tune configuration
+static constexpr double RELAY_HYSTERESIS = 0.05;
+static constexpr unsigned RELAY_CYCLES = 4u;
+static constexpr unsigned RELAY_MAX_TICKS = 3000u;
+// Initial Twiddle coefficients, as a fraction of the relay auto-tuned gains
+static constexpr double RELAY_TWIDDLE_FRACTION = 0.1;
+
+// Weight of a new round-trip delay sample in its running average
+static constexpr double DELAY_SMOOTHING = 0.1;
+
+// Bounds on the measured tick length, in nominal ticks, so that pauses (e.g. simulator resets)
+// or bursts of coalesced frames do not blow up the integral or derivative terms
+static constexpr double MIN_TICK_RATIO = 0.1;
+static constexpr double MAX_TICK_RATIO = 10.0;
+
+// Largest steering angle of the simulator, in degrees; the end of the gain schedule's curvature axis
+static constexpr double MAX_STEERING_ANGLE = 25.0;
+
+// Adaptive tuning configuration
+static constexpr double ADAPTIVE_FORGETTING = 0.995;
+static constexpr double ADAPTIVE_SMOOTHING = 0.01;
+static constexpr double ADAPTIVE_MAX_GAIN = 5.0;
+static constexpr unsigned ADAPTIVE_LOG_EVERY_N_TICKS = 500u;
+
+// Messages the asynchronous logger can hold before dropping new ones
+static constexpr size_t ASYNC_LOG_QUEUE_SIZE = 8192u;
+// How often throttled logging reports the messages it suppressed
+static constexpr std::chrono::seconds LOG_SUMMARY_INTERVAL(10);
+// Trace records buffered between the control thread and the trace writer
+static constexpr size_t TRACE_RING_RECORDS = 16384u;
+
+static uint64_t nanosBetween(Clock::time_point from, Clock::time_point to)
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count());
+}
+
+/*
+* Replaces the default console logger when logging asynchronously, also to a file, or throttled.
+*/
+static bool setUpLogging(const Options& options)
+{
+    const bool throttle = options.logRate > 0.0 || options.logSample > 1u;
+    if (not options.asyncLog && options.logFile.empty() && not throttle)
+    {
+        return true;
+    }
+
+    std::vector<spdlog::sink_ptr> sinks {std::make_shared<spdlog::sinks::stdout_color_sink_mt>()};
+    if (not options.logFile.empty())
+    {
+        try
+        {
+            sinks.push_back(std::make_shared<spdlog::sinks::gzip_rotating_file_sink_mt>(
+                options.logFile, static_cast<size_t>(options.logFileMb) << 20u, options.logFiles));
+        }
+        catch (const spdlog::spdlog_ex& e)
+        {
+            spdlog::error("Could not open log file {}: {}", options.logFile, e.what());
+            return false;
+        }
+    }
+
+    if (throttle)
+    {
+        // Bursts of up to a second's worth of messages per site pass
+        auto throttled = std::make_shared<spdlog::sinks::throttled_sink_mt>(
+            options.logRate, options.logRate, options.logSample, LOG_SUMMARY_INTERVAL);
+        throttled->set_sinks(sinks);
+        sinks = {throttled};
+    }
+
+    std::shared_ptr<spdlog::logger> logger;
+    if (options.asyncLog)
+    {
+        spdlog::init_thread_pool(ASYNC_LOG_QUEUE_SIZE, 1u);
+        logger = std::make_shared<spdlog::async_logger>("pid", sinks.begin(), sinks.end(), spdlog::thread_pool(),
+                                                        spdlog::async_overflow_policy::overrun_oldest);
+    }
+    else
+    {
+        logger = std::make_shared<spdlog::logger>("pid", sinks.begin(), sinks.end());
+    }
+    logger->set_level(static_cast<spdlog::level::level_enum>(SPDLOG_ACTIVE_LEVEL));
+    spdlog::set_default_logger(logger);
+    return true;
+}
+
+int main(int argc, char* argv[])
 {
-    uWS::Hub h;
-    spdlog::set_level(spdlog::level::info);
+    spdlog::set_level(static_cast<spdlog::level::level_enum>(SPDLOG_ACTIVE_LEVEL));
+
+    Options options;
+    if (not ParseOptions(argc, argv, options))
+    {
+        return -1;
+    }
+
+    if (not setUpLogging(options))
+    {
+        return -1;
+    }
 
     PID pid;
     // Best found params go here:
     // pid.UpdateParams({0.152734, 0, 0.820703});
+    if (not options.initParams.empty())
+    {
+        pid.UpdateParams(options.initParams);
+    }
     std::vector<double> pidParams = pid.GetParams();
 
-    bool enableTwiddle = true;
+    const bool useSchedule = options.scheduleSpeedNodes > 0u && not options.adaptive;
+    GainSchedule schedule(options.scheduleSpeedNodes, options.scheduleMaxSpeed,
+                          options.scheduleCurvatureNodes, MAX_STEERING_ANGLE,
+                          {pidParams[0], pidParams[1], pidParams[2]});
+    if (useSchedule)
+    {
+        // The tuner tunes the gains of every schedule node instead of a single PID
+        pidParams = schedule.GetParams();
+        spdlog::info("Scheduling gains over {} speed and {} curvature nodes",
+                     options.scheduleSpeedNodes, options.scheduleCurvatureNodes);
+    }
+
+    bool enableTuning = not options.adaptive;
 
-    if (enableTwiddle)
+    if (enableTuning)
     {
-        spdlog::info("Enabling twiddle.");
+        spdlog::info("Enabling {} tuner.", options.tuner);
     }
     else
     {
-        spdlog::info("Twiddle is disabled;");
+        spdlog::info("Episode tuning is disabled;");
     }
 
     Twiddle twiddle(TWIDDLE_TOLERANCE);
     // Set initial twiddle coefficients:
-    twiddle.SetCoefficients({0.1, 0.1, 0.1});
+    twiddle.SetCoefficients(std::vector<double>(pidParams.size(), 0.1));
+
+    std::vector<double> lowerGains(pidParams.size(), 0.0);
+    std::vector<double> upperGains(pidParams.size());
+    for (size_t i = 0; i < upperGains.size(); ++i)
+    {
+        upperGains[i] = MAX_TUNED_GAINS[i % MAX_TUNED_GAINS.size()];
+    }
+    BayesOpt bayesOpt(lowerGains, upperGains, options.tunerBudget, options.bayesBatch, options.seed);
+    Hyperband hyperband(lowerGains, upperGains, std::max(options.hyperbandMinTicks, ALLOW_ALL_IN_FIRST_N_TICKS),
+                        TERMINATE_AFTER_N_TICKS, HYPERBAND_ETA, options.seed);
+
+    Tuner& tuner = options.tuner == "bayes" ? static_cast<Tuner&>(bayesOpt)
+                 : options.tuner == "hyperband" ? static_cast<Tuner&>(hyperband)
+                 : static_cast<Tuner&>(twiddle);
+    std::vector<double> incumbent;  // Best params the tuner found so far
+
+    RelayAutoTune relay(options.relayAmplitude, RELAY_HYSTERESIS, RELAY_CYCLES);
+    // Adaptive tuning only refines gains that already keep the car on the track, so without initial gains
+    // it starts from the relay auto-tuned ones
+    bool enableRelay = options.relayAutoTune || (options.adaptive && options.initParams.empty());
+    unsigned relayTick { 0u };
+    if (enableRelay)
+    {
+        spdlog::info("Running relay auto-tune before tuning.");
+    }
 
-    h.onMessage([&](uWS::WebSocket<uWS::SERVER> ws, char *data, size_t length, uWS::OpCode opCode)
+    AdaptiveTuner adaptive(ADAPTIVE_FORGETTING, options.adaptivePole, ADAPTIVE_SMOOTHING, ADAPTIVE_MAX_GAIN,
+                           options.adaptiveDither);
+    unsigned adaptiveTick { 0u };
+    std::vector<double> adaptiveSeed = pidParams;  // Gains adaptation restarts from when the car leaves the track
+    if (options.adaptive)
     {
-        if (not (length && length > 2 && data[0] == '4' && data[1] == '2'))
+        spdlog::info("Enabling online adaptive tuning.");
+    }
+
+    // Jitter report: spacing of telemetry arrivals and time spent handling each of them
+    const char* modeName = options.realTime ? "real-time" : "default";
+    LatencyHistogram arrivalInterval;
+    LatencyHistogram serviceTime;
+    Clock::time_point prevArrival;
+
+    DeadlineWatchdog watchdog(static_cast<uint64_t>(options.deadlineUs) * 1000u);
+    DelayCompensator compensator(options.latencyModelGain, DELAY_SMOOTHING);
+    Clock::time_point prevTelemetry;
+
+    // Per-tick binary trace, formatted offline by pid_trace_decode
+    TraceLog trace(TRACE_RING_RECORDS);
+    const uint16_t traceTick = trace.Register("CTE: {}, Predicted CTE: {}, Delay: {}s, Steering Value: {}, Speed: {}, dt: {}");
+    if (not options.tracePath.empty() && not trace.Open(options.tracePath))
+    {
+        return -1;
+    }
+
+    std::unique_ptr<Transport> transport = CreateTransport(options);
+    if (not transport)
+    {
+        return -1;
+    }
+
+    double lastSteering = 0.0;
+    bool steered = false;
+
+    const auto sendSteer = [&](double steering)
+    {
+        lastSteering = steering;
+        steered = true;
+        transport->SendSteer(steering, options.throttle);
+    };
+
+    const auto sendReset = [&]()
+    {
+        transport->SendReset();
+    };
+
+    // Deadline report, over its own window so it does not depend on the jitter report
+    const auto reportDeadlines = [&]()
+    {
+        if (options.deadlineReportTicks > 0u && watchdog.WindowTicks() >= options.deadlineReportTicks)
         {
-            // "42" at the start of the message means there's a websocket message event.
-            // The 4 signifies a websocket message
-            // The 2 signifies a websocket event
-            return;
+            spdlog::info("Deadline report: {}", watchdog.Summary());
+            watchdog.ResetWindow();
         }
+    };
 
-        auto s = hasData(string(data).substr(0, length));
-        if (s == "")
+    // One control tick: tuning, the PID and the steering reply
+    const auto onTelemetry = [&](Clock::time_point arrival, double cte, double speed, double angle)
+    {
+        compensator.OnTelemetry(arrival);
+
+        // Elapsed time since the previous telemetry, in nominal ticks
+        double dt = 1.0;
+        if (options.nominalTickMs > 0.0 && prevTelemetry != Clock::time_point())
         {
-            // Manual driving
-            string msg = "42[\"manual\",{}]";
-            ws.send(msg.data(), msg.length(), uWS::OpCode::TEXT);
-            return;
+            const double elapsedMs = std::chrono::duration<double, std::milli>(arrival - prevTelemetry).count();
+            dt = std::min(std::max(elapsedMs / options.nominalTickMs, MIN_TICK_RATIO), MAX_TICK_RATIO);
         }
+        prevTelemetry = arrival;
 
-        auto j = json::parse(s);
-        string event = j[0].get<string>();
-
-        if (event == "telemetry")
+        if (enableRelay)
         {
-            // j[1] is the data JSON object
-            double cte = std::stod(j[1]["cte"].get<string>());
-            double speed = std::stod(j[1]["speed"].get<string>());
-            // double angle = std::stod(j[1]["steering_angle"].get<string>());
+            const double steer = relay.Apply(cte, dt);
+            relayTick++;
 
-            if (enableTwiddle)
+            if (relay.Done() || relayTick >= RELAY_MAX_TICKS || std::abs(cte) > MAX_ALLOWED_CTE)
             {
-                static unsigned twiddleTick { 0u };  // Computes how many ticks have passed since twiddle was called
-
-                const bool ranVeryLong = twiddleTick >= TERMINATE_AFTER_N_TICKS;
-                const bool errorTooLarge = cte > MAX_ALLOWED_CTE;
-                const bool gotTooSlow = speed < MIN_ALLOWED_SPEED;
-                if (twiddleTick >= ALLOW_ALL_IN_FIRST_N_TICKS && (ranVeryLong || errorTooLarge || gotTooSlow))
+                enableRelay = false;
+                if (relay.Done())
                 {
-                    // Convert run time to error that twiddle expects
-                    const double twiddleError = std::numeric_limits<unsigned>::max() - twiddleTick;
-
-                    const auto prevParams = pid.GetParams();
-                    const bool twiddleDone = twiddle.runOnce(twiddleError, pidParams);
-                    pid.UpdateParams(pidParams);  // Could be a reference instead, maybe
-                    if (prevParams == pidParams)
+                    // Seed the PID (every schedule node) and the Twiddle step sizes with the Ziegler–Nichols gains
+                    const auto gains = relay.GetGains();
+                    std::vector<double> coeffs(pidParams.size());
+                    for (size_t i = 0; i < pidParams.size(); ++i)
+                    {
+                        pidParams[i] = gains[i % gains.size()];
+                        coeffs[i] = RELAY_TWIDDLE_FRACTION * gains[i % gains.size()];
+                    }
+                    twiddle.SetCoefficients(coeffs);
+                    adaptiveSeed = pidParams;
+                    if (useSchedule)
                     {
-                        spdlog::warn("Found better PID params: {}, {}, {}", pidParams[0], pidParams[1], pidParams[2]);
+                        schedule.UpdateParams(pidParams);
                     }
                     else
                     {
-                        spdlog::info("Trying PID params: {}, {}, {}", pidParams[0], pidParams[1], pidParams[2]);
+                        pid.UpdateParams(pidParams);
                     }
+                    spdlog::warn("Relay auto-tune: Ku {}, Tu {} ticks, PID params: {}",
+                                 relay.GetUltimateGain(), relay.GetUltimatePeriod(), fmt::join(pidParams, ", "));
+                }
+                else
+                {
+                    spdlog::error("Relay auto-tune did not settle into an oscillation, keeping the initial gains.");
+                }
 
-                    const auto twiddleCoeffs = twiddle.GetCoefficients();
-                    spdlog::info("Twiddle coefficients: {}, {}, {}", twiddleCoeffs[0], twiddleCoeffs[1], twiddleCoeffs[2]);
+                // Start tuning from the track start
+                sendReset();
+            }
 
-                    // Reset simulator
-                    const string msg = "42[\"reset\",{}]";
-                    ws.send(msg.data(), msg.length(), uWS::OpCode::TEXT);
+            sendSteer(steer);
+            return;
+        }
 
-                    // Maybe terminate Twiddle
-                    if (ranVeryLong)
-                    {
-                        enableTwiddle = false;
-                        spdlog::warn("Managed to run long enough! Terminating Twiddle.");
-                        spdlog::warn("Final params: {}, {}, {}", pidParams[0], pidParams[1], pidParams[2]);
-                    }
-                    if (twiddleDone)
-                    {
-                        enableTwiddle = false;
-                        spdlog::warn("Twiddle tolerance reached! Terminating Twiddle.");
-                        spdlog::warn("Final params: {}, {}, {}", pidParams[0], pidParams[1], pidParams[2]);
-                    }
+        if (enableTuning)
+        {
+            static unsigned tuningTick { 0u };  // Computes how many ticks have passed since the tuner was called
+            static double tuningCteSum { 0.0 };
+
+            // Multi-fidelity tuners run shorter episodes for candidates they are not yet sure about
+            const unsigned episodeTicks = tuner.GetEpisodeTicks(TERMINATE_AFTER_N_TICKS);
+            const bool ranVeryLong = tuningTick >= episodeTicks;
+            const bool errorTooLarge = cte > MAX_ALLOWED_CTE;
+            const bool gotTooSlow = speed < MIN_ALLOWED_SPEED;
+            if (tuningTick >= ALLOW_ALL_IN_FIRST_N_TICKS && (ranVeryLong || errorTooLarge || gotTooSlow))
+            {
+                // Convert run time to error that the tuner expects. The mean CTE, scaled below one tick,
+                // only breaks ties between episodes of the same length (e.g. ones cut at the same budget).
+                const double meanCte = tuningTick > 0u ? tuningCteSum / tuningTick : 0.0;
+                const double tuningError = std::numeric_limits<unsigned>::max() - tuningTick
+                                           + std::min(meanCte / MAX_ALLOWED_CTE, 0.99);
 
-                    twiddleTick = 0u;
+                bool tuningDone = tuner.runOnce(tuningError, pidParams);
+
+                // The tuner hands back the next candidate, so the best gains so far are tracked separately
+                const auto best = tuner.GetBestParams();
+                if (not best.empty() && best != incumbent)
+                {
+                    incumbent = best;
+                    spdlog::warn("Found better PID params: {}", fmt::join(incumbent, ", "));
                 }
 
-                twiddleTick++;
-            }  // end if(enableTwiddle)
+                // Hyperband runs many candidates to full length and compares them, so it decides itself when to stop
+                if (ranVeryLong && episodeTicks >= TERMINATE_AFTER_N_TICKS && &tuner != &hyperband)
+                {
+                    // Drive on the best gains, which completed a full episode, rather than on the next candidate
+                    tuningDone = true;
+                    spdlog::warn("Managed to run long enough! Terminating tuning.");
+                }
+                else if (tuningDone)
+                {
+                    spdlog::warn("Tuner finished! Terminating tuning.");
+                }
+                if (tuningDone && not incumbent.empty())
+                {
+                    pidParams = incumbent;
+                }
 
-            double steer_value = pid.Apply(cte);
+                if (useSchedule)
+                {
+                    schedule.UpdateParams(pidParams);
+                }
+                else
+                {
+                    pid.UpdateParams(pidParams);  // Could be a reference instead, maybe
+                }
+                if (tuningDone)
+                {
+                    enableTuning = false;
+                    spdlog::warn("Final params: {}", fmt::join(pidParams, ", "));
+                }
+                else
+                {
+                    spdlog::info("Trying PID params: {}", fmt::join(pidParams, ", "));
+                }
 
-            // DEBUG
-            spdlog::debug("CTE: {}, Steering Value: {}, Speed: {}", cte, steer_value, speed);
+                if (&tuner == &twiddle)
+                {
+                    const auto twiddleCoeffs = twiddle.GetCoefficients();
+                    spdlog::info("Twiddle coefficients: {}", fmt::join(twiddleCoeffs, ", "));
+                }
 
-            json msgJson;
-            msgJson["steering_angle"] = steer_value;
-            msgJson["throttle"] = 0.3;
-            auto msg = "42[\"steer\"," + msgJson.dump() + "]";
-            spdlog::debug("Message: {}", msg);
-            ws.send(msg.data(), msg.length(), uWS::OpCode::TEXT);
+                // Reset simulator
+                sendReset();
+
+                tuningTick = 0u;
+                tuningCteSum = 0.0;
+            }
+
+            tuningTick++;
+            tuningCteSum += std::abs(cte);
+        }  // end if(enableTuning)
+
+        if (options.deadlineFallback && steered && watchdog.Expired(arrival, Clock::now()))
+        {
+            // Too late to be useful: repeat the previous command rather than adding more delay
+            watchdog.CountFallback();
+            sendSteer(lastSteering);
+            compensator.OnCommand(Clock::now(), lastSteering);
+            watchdog.Finish(arrival, Clock::now());
+            reportDeadlines();
+            return;
+        }
+
+        if (useSchedule)
+        {
+            const auto gains = schedule.Lookup(speed, std::abs(angle));
+            pid.UpdateParams(gains[0], gains[1], gains[2]);
+        }
+
+        if (options.adaptive && std::abs(cte) > MAX_ALLOWED_CTE)
+        {
+            // Off the track: adapting further would only fit the model to a crash, so start over from the seed
+            spdlog::warn("Adaptive tuning left the track (CTE {}), restarting from PID params: {}",
+                         cte, fmt::join(adaptiveSeed, ", "));
+            pidParams = adaptiveSeed;
+            pid.UpdateParams(pidParams);
+            pid.Reset();
+            adaptive.Restart();
+            sendReset();
+            sendSteer(0.0);
+            return;
+        }
+
+        if (options.adaptive)
+        {
+            adaptive.Observe(cte);
+            if (adaptive.UpdateGains(pidParams))
+            {
+                pid.UpdateParams(pidParams);
+            }
+            if (++adaptiveTick % ADAPTIVE_LOG_EVERY_N_TICKS == 0u)
+            {
+                const auto model = adaptive.GetModel();
+                spdlog::info("Adaptive model: {}, PID params: {}", fmt::join(model, ", "), fmt::join(pidParams, ", "));
+            }
         }
-    });
 
-    h.onConnection([&h](uWS::WebSocket<uWS::SERVER> ws, uWS::HttpRequest req)
+        const double controlledCte = options.latencyCompensation ? compensator.Predict(cte, speed, arrival) : cte;
+        double steer_value = pid.Apply(controlledCte, dt);
+        if (options.adaptive)
+        {
+            steer_value = adaptive.Excite(steer_value);
+            adaptive.OnCommand(steer_value);
+        }
+
+        // DEBUG, compiled out unless SPDLOG_ACTIVE_LEVEL enables it
+        SPDLOG_DEBUG("CTE: {}, Predicted CTE: {}, Delay: {}s, Steering Value: {}, Speed: {}",
+                     cte, controlledCte, compensator.DelaySeconds(), steer_value, speed);
+
+        if (trace.IsOpen())
+        {
+            trace.Log(traceTick, cte, controlledCte, compensator.DelaySeconds(), steer_value, speed, dt);
+        }
+
+        sendSteer(steer_value);
+        compensator.OnCommand(Clock::now(), steer_value);
+
+        if (watchdog.Finish(arrival, Clock::now()))
+        {
+            SPDLOG_WARN("Missed steering deadline, {} misses so far", watchdog.Misses());
+        }
+        reportDeadlines();
+
+        if (options.jitterReportTicks > 0u)
+        {
+            if (prevArrival != Clock::time_point())
+            {
+                arrivalInterval.Record(nanosBetween(prevArrival, arrival));
+            }
+            prevArrival = arrival;
+            serviceTime.Record(nanosBetween(arrival, Clock::now()));
+
+            if (serviceTime.Count() >= options.jitterReportTicks)
+            {
+                spdlog::info("Jitter report ({} mode) tick interval: {}", modeName, arrivalInterval.Summary());
+                spdlog::info("Jitter report ({} mode) service time: {}", modeName, serviceTime.Summary());
+                arrivalInterval.Reset();
+                serviceTime.Reset();
+            }
+        }
+    };
+
+    // A new simulator session
+    transport->OnConnection([&]()
     {
         spdlog::debug("Connected!!!");
+        prevArrival = Clock::time_point();
+        steered = false;
+        compensator.Reset();
+        prevTelemetry = Clock::time_point();
+        arrivalInterval.Reset();
+        serviceTime.Reset();
     });
 
-    h.onDisconnection([&h](uWS::WebSocket<uWS::SERVER> ws, int code, char *message, size_t length)
+    transport->OnTelemetry([&](Clock::time_point arrival, const Telemetry& telemetry)
     {
-        ws.close();
-        spdlog::info("Disconnected");
+        onTelemetry(arrival, telemetry.cte, telemetry.speed, telemetry.steeringAngle);
     });
 
-    int port = 4567;
-    if (h.listen(port))
+    if (not transport->Listen())
     {
-        spdlog::info("Listening to port {}", port);
+        return -1;
     }
-    else
+
+    if (options.realTime)
     {
-        spdlog::error("Failed to listen to port");
-        return -1;
+        // The transport runs its event loop on this thread, so it is the one that becomes real-time
+        EnableRealTime(options.cpu, options.rtPriority, static_cast<size_t>(options.prefaultMb) * 1024u * 1024u);
     }
 
-    h.run();
+    transport->Run();
 }
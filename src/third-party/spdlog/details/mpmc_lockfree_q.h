@@ -0,0 +1,241 @@
+#pragma once
+
+//
+// Not part of upstream spdlog: added by the PID controller project and
+// distributed under its license (see LICENSE at the repository root).
+//
+
+// multi producer-multi consumer bounded lock-free queue (Dmitry Vyukov's
+// algorithm), a drop-in replacement for mpmc_blocking_queue that never takes a
+// lock on the logging thread. Selected by defining SPDLOG_LOCK_FREE_QUEUE.
+// enqueue(..) - will spin/yield until room found to put the new message.
+// enqueue_nowait(..) - will return immediately if no room left in the queue.
+// unlike mpmc_blocking_queue, the new message is dropped (and counted as an
+// overrun) instead of the oldest one, as overwriting a slot another thread may
+// be reading cannot be done without a lock.
+// dequeue_for(..) - will poll until the queue is not empty or timeout have
+// passed. an idle consumer spins, then yields, then sleeps on a condition
+// variable; producers only take its mutex to wake a sleeping consumer, so a
+// busy queue stays lock-free and the first message after an idle period is
+// not delayed by a polling interval.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace spdlog {
+namespace details {
+
+template<typename T>
+class mpmc_lockfree_queue
+{
+public:
+    using item_type = T;
+    explicit mpmc_lockfree_queue(size_t max_items)
+        : mask_(round_up_pow2_(max_items) - 1)
+        , cells_(new cell[mask_ + 1])
+    {
+        for (size_t i = 0; i <= mask_; i++)
+        {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    mpmc_lockfree_queue(const mpmc_lockfree_queue &) = delete;
+    mpmc_lockfree_queue &operator=(const mpmc_lockfree_queue &) = delete;
+
+    // try to enqueue and spin if no room left
+    void enqueue(T &&item)
+    {
+        for (unsigned spins = 0; !try_enqueue_(item); spins++)
+        {
+            backoff_(spins);
+        }
+        wake_consumer_();
+    }
+
+    // enqueue immediately. drop the new message if no room left in the queue.
+    void enqueue_nowait(T &&item)
+    {
+        if (!try_enqueue_(item))
+        {
+            overrun_counter_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        wake_consumer_();
+    }
+
+    // try to dequeue item. if no item found. spin briefly, then wait upto
+    // timeout. Return true, if succeeded dequeue item, false otherwise
+    bool dequeue_for(T &popped_item, std::chrono::milliseconds wait_duration)
+    {
+        for (unsigned spins = 0; spins < spin_limit; spins++)
+        {
+            if (try_dequeue_(popped_item))
+            {
+                return true;
+            }
+            if (spins >= spin_limit / 2)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        const auto deadline = std::chrono::steady_clock::now() + wait_duration;
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        for (;;)
+        {
+            // announce the sleep before the last check, so that a producer
+            // whose message that check misses sees it and notifies
+            sleepers_.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (try_dequeue_(popped_item))
+            {
+                sleepers_.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+            const std::cv_status status = sleep_cv_.wait_until(lock, deadline);
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+            if (try_dequeue_(popped_item))
+            {
+                return true;
+            }
+            if (status == std::cv_status::timeout)
+            {
+                return false;
+            }
+        }
+    }
+
+    size_t overrun_counter()
+    {
+        return overrun_counter_.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t cache_line_size = 64;
+    static constexpr unsigned spin_limit = 128;
+
+    struct cell
+    {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    static size_t round_up_pow2_(size_t n)
+    {
+        size_t pow2 = 2;
+        while (pow2 < n)
+        {
+            pow2 <<= 1;
+        }
+        return pow2;
+    }
+
+    // producer waiting for room in a full queue: spin briefly, then yield,
+    // then poll every 100us rather than burn a core.
+    static void backoff_(unsigned spins)
+    {
+        if (spins < spin_limit / 2)
+        {
+            return;
+        }
+        if (spins < spin_limit)
+        {
+            std::this_thread::yield();
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    // the fence orders the enqueued cell before the sleepers_ load, pairing
+    // with the one in dequeue_for. the mutex is only taken while a consumer
+    // sleeps, and holding it means that consumer is either already waiting or
+    // has not made its last check yet.
+    void wake_consumer_()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(sleep_mutex_);
+            }
+            sleep_cv_.notify_all();
+        }
+    }
+
+    bool try_enqueue_(T &item)
+    {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell &c = cells_[pos & mask_];
+            const size_t seq = c.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0)
+            {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    c.data = std::move(item);
+                    c.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false; // full
+            }
+            else
+            {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_dequeue_(T &popped_item)
+    {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell &c = cells_[pos & mask_];
+            const size_t seq = c.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    popped_item = std::move(c.data);
+                    c.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false; // empty
+            }
+            else
+            {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    const size_t mask_;
+    std::unique_ptr<cell[]> cells_;
+
+    // producers and consumers each own a cache line
+    alignas(cache_line_size) std::atomic<size_t> enqueue_pos_{0};
+    alignas(cache_line_size) std::atomic<size_t> dequeue_pos_{0};
+    alignas(cache_line_size) std::atomic<size_t> overrun_counter_{0};
+
+    // idle consumers wait here
+    alignas(cache_line_size) std::atomic<unsigned> sleepers_{0};
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+};
+} // namespace details
+} // namespace spdlog
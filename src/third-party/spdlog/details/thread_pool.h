@@ -2,7 +2,11 @@
 
 #include "spdlog/details/fmt_helper.h"
 #include "spdlog/details/log_msg.h"
+#ifdef SPDLOG_LOCK_FREE_QUEUE
+#include "spdlog/details/mpmc_lockfree_q.h"
+#else
 #include "spdlog/details/mpmc_blocking_q.h"
+#endif
 #include "spdlog/details/os.h"
 
 #include <chrono>
@@ -119,7 +123,11 @@ class thread_pool
 {
 public:
     using item_type = async_msg;
+#ifdef SPDLOG_LOCK_FREE_QUEUE
+    using q_type = details::mpmc_lockfree_queue<item_type>;
+#else
     using q_type = details::mpmc_blocking_queue<item_type>;
+#endif
 
     thread_pool(size_t q_max_items, size_t threads_n)
         : q_(q_max_items)
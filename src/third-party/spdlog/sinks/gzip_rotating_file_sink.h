@@ -0,0 +1,290 @@
+//
+// Not part of upstream spdlog: added by the PID controller project and
+// distributed under its license (see LICENSE at the repository root).
+//
+
+#pragma once
+
+#ifndef SPDLOG_H
+#include "spdlog/spdlog.h"
+#endif
+
+#include "spdlog/details/file_helper.h"
+#include "spdlog/details/null_mutex.h"
+#include "spdlog/fmt/fmt.h"
+#include "spdlog/sinks/base_sink.h"
+#include "spdlog/sinks/rotating_file_sink.h"
+
+#include <zlib.h>
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace spdlog {
+namespace sinks {
+
+//
+// Rotating file sink based on size, whose closed segments are gzip compressed
+// on a background thread (requires zlib, link with -lz):
+// log.txt -> log.1.txt -> log.1.txt.gz, log.1.txt.gz -> log.2.txt.gz, ...
+// Logging only pays for a rename at rotation; it waits for the compressor
+// only if the previous segment is still being compressed. A segment whose
+// compression failed is compressed again at the next rotation, and kept
+// uncompressed as log.1.N.txt if that fails too, so it is never deleted.
+//
+template<typename Mutex>
+class gzip_rotating_file_sink final : public base_sink<Mutex>
+{
+public:
+    gzip_rotating_file_sink(filename_t base_filename, std::size_t max_size, std::size_t max_files, int level = Z_DEFAULT_COMPRESSION)
+        : base_filename_(std::move(base_filename))
+        , max_size_(max_size)
+        , max_files_(max_files)
+        , level_(level)
+    {
+        file_helper_.open(base_filename_);
+        current_size_ = file_helper_.size(); // expensive. called only once
+        worker_ = std::thread(&gzip_rotating_file_sink::worker_loop_, this);
+
+        // a segment left uncompressed by a previous run
+        if (max_files_ > 0 && details::file_helper::file_exists(segment_filename_(1)))
+        {
+            compress_async_(segment_filename_(1));
+        }
+    }
+
+    ~gzip_rotating_file_sink() override
+    {
+        {
+            std::unique_lock<std::mutex> lock(jobs_mutex_);
+            stop_ = true;
+        }
+        jobs_cv_.notify_all();
+        worker_.join();
+    }
+
+    gzip_rotating_file_sink(const gzip_rotating_file_sink &) = delete;
+    gzip_rotating_file_sink &operator=(const gzip_rotating_file_sink &) = delete;
+
+    // e.g. compressed_filename("logs/mylog.txt", 3) => "logs/mylog.3.txt.gz".
+    static filename_t compressed_filename(const filename_t &filename, std::size_t index)
+    {
+        return rotating_file_sink<Mutex>::calc_filename(filename, index) + SPDLOG_FILENAME_T(".gz");
+    }
+
+    const filename_t &filename() const
+    {
+        return file_helper_.filename();
+    }
+
+    // block until every closed segment is compressed
+    void wait_compressed()
+    {
+        std::unique_lock<std::mutex> lock(jobs_mutex_);
+        idle_cv_.wait(lock, [this] { return jobs_.empty() && !busy_; });
+    }
+
+protected:
+    void sink_it_(const details::log_msg &msg) override
+    {
+        fmt::memory_buffer formatted;
+        sink::formatter_->format(msg, formatted);
+        current_size_ += formatted.size();
+        if (current_size_ > max_size_)
+        {
+            rotate_();
+            current_size_ = formatted.size();
+        }
+        file_helper_.write(formatted);
+    }
+
+    void flush_() override
+    {
+        file_helper_.flush();
+    }
+
+private:
+    filename_t segment_filename_(std::size_t index) const
+    {
+        return rotating_file_sink<Mutex>::calc_filename(base_filename_, index);
+    }
+
+    // Rotate files:
+    // log.2.txt.gz -> log.3.txt.gz (log.3.txt.gz deleted if it is the last one)
+    // log.1.txt.gz -> log.2.txt.gz
+    // log.txt -> log.1.txt, compressed in the background to log.1.txt.gz
+    void rotate_()
+    {
+        using details::os::filename_to_str;
+        file_helper_.close();
+        if (max_files_ == 0)
+        {
+            file_helper_.reopen(true);
+            return;
+        }
+
+        // the segment being compressed must reach its final name before shifting,
+        // and one whose compression failed must not be overwritten
+        wait_compressed();
+        filename_t closed = segment_filename_(1);
+        if (details::file_helper::file_exists(closed) && !compress_(closed) && !keep_uncompressed_(closed))
+        {
+            file_helper_.reopen(false); // keep appending rather than lose the segment
+            return;
+        }
+
+        for (auto i = max_files_; i > 1; --i)
+        {
+            filename_t src = compressed_filename(base_filename_, i - 1);
+            if (details::file_helper::file_exists(src))
+            {
+                (void)details::os::remove(compressed_filename(base_filename_, i));
+                (void)details::os::rename(src, compressed_filename(base_filename_, i));
+            }
+        }
+
+        if (details::os::rename(base_filename_, closed) != 0)
+        {
+            file_helper_.reopen(true); // truncate the log file anyway to prevent it to grow beyond its limit!
+            current_size_ = 0;
+            throw spdlog_ex("gzip_rotating_file_sink: failed renaming " + filename_to_str(base_filename_) + " to " +
+                                filename_to_str(closed),
+                errno);
+        }
+        file_helper_.reopen(true);
+        compress_async_(closed);
+    }
+
+    // move a segment that cannot be compressed out of the rotation, to the
+    // first free log.1.N.txt
+    bool keep_uncompressed_(const filename_t &filename)
+    {
+        for (std::size_t i = 1; i < max_kept_uncompressed; ++i)
+        {
+            filename_t kept = rotating_file_sink<Mutex>::calc_filename(filename, i);
+            if (!details::file_helper::file_exists(kept))
+            {
+                return details::os::rename(filename, kept) == 0;
+            }
+        }
+        return false;
+    }
+
+    void compress_async_(const filename_t &filename)
+    {
+        {
+            std::unique_lock<std::mutex> lock(jobs_mutex_);
+            jobs_.push_back(filename);
+        }
+        jobs_cv_.notify_one();
+    }
+
+    void worker_loop_()
+    {
+        std::unique_lock<std::mutex> lock(jobs_mutex_);
+        for (;;)
+        {
+            jobs_cv_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+            if (jobs_.empty())
+            {
+                return; // stopped, with nothing left to compress
+            }
+
+            filename_t filename = jobs_.front();
+            jobs_.pop_front();
+            busy_ = true;
+            lock.unlock();
+            compress_(filename);
+            lock.lock();
+            busy_ = false;
+            idle_cv_.notify_all();
+        }
+    }
+
+    // stream the file through zlib into a temporary .gz, then replace the
+    // uncompressed file with it. errors leave the uncompressed file in place
+    // and return false.
+    bool compress_(const filename_t &filename)
+    {
+        using details::os::filename_to_str;
+        const filename_t target = filename + SPDLOG_FILENAME_T(".gz");
+        const filename_t partial = target + SPDLOG_FILENAME_T(".tmp");
+
+        std::FILE *in = nullptr;
+        if (details::os::fopen_s(&in, filename, SPDLOG_FILENAME_T("rb")))
+        {
+            return false;
+        }
+        gzFile out = gzopen(filename_to_str(partial).c_str(), fmt::format("wb{}", level_ < 0 ? 6 : level_).c_str());
+        if (out == nullptr)
+        {
+            std::fclose(in);
+            return false;
+        }
+
+        bool ok = true;
+        char chunk[64 * 1024];
+        size_t read = 0;
+        while (ok && (read = std::fread(chunk, 1, sizeof(chunk), in)) > 0)
+        {
+            ok = gzwrite(out, chunk, static_cast<unsigned>(read)) == static_cast<int>(read);
+        }
+        ok = !std::ferror(in) && ok;
+        std::fclose(in);
+        ok = gzclose(out) == Z_OK && ok;
+
+        if (ok && details::os::rename(partial, target) == 0)
+        {
+            (void)details::os::remove(filename);
+            return true;
+        }
+        (void)details::os::remove(partial);
+        return false;
+    }
+
+    static constexpr std::size_t max_kept_uncompressed = 1000;
+
+    filename_t base_filename_;
+    std::size_t max_size_;
+    std::size_t max_files_;
+    int level_;
+    std::size_t current_size_ = 0;
+    details::file_helper file_helper_;
+
+    std::mutex jobs_mutex_;
+    std::condition_variable jobs_cv_;
+    std::condition_variable idle_cv_;
+    std::deque<filename_t> jobs_;
+    bool busy_ = false;
+    bool stop_ = false;
+    std::thread worker_;
+};
+
+using gzip_rotating_file_sink_mt = gzip_rotating_file_sink<std::mutex>;
+using gzip_rotating_file_sink_st = gzip_rotating_file_sink<details::null_mutex>;
+
+} // namespace sinks
+
+//
+// factory functions
+//
+
+template<typename Factory = default_factory>
+inline std::shared_ptr<logger> gzip_rotating_logger_mt(
+    const std::string &logger_name, const filename_t &filename, size_t max_file_size, size_t max_files)
+{
+    return Factory::template create<sinks::gzip_rotating_file_sink_mt>(logger_name, filename, max_file_size, max_files);
+}
+
+template<typename Factory = default_factory>
+inline std::shared_ptr<logger> gzip_rotating_logger_st(
+    const std::string &logger_name, const filename_t &filename, size_t max_file_size, size_t max_files)
+{
+    return Factory::template create<sinks::gzip_rotating_file_sink_st>(logger_name, filename, max_file_size, max_files);
+}
+} // namespace spdlog
@@ -0,0 +1,238 @@
+//
+// Not part of upstream spdlog: added by the PID controller project and
+// distributed under its license (see LICENSE at the repository root).
+//
+
+#pragma once
+
+#ifndef SPDLOG_H
+#include "spdlog/spdlog.h"
+#endif
+
+#include "dist_sink.h"
+#include "spdlog/details/log_msg.h"
+#include "spdlog/details/null_mutex.h"
+#include "spdlog/fmt/fmt.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Throttling distribution sink. Messages are limited per site: the call site
+// for messages logged with a source location (the SPDLOG_* macros), the logger
+// and level for the others. Only every sample_every-th message of a site is
+// considered, and those pass only while the site's token bucket (rate_per_sec,
+// up to burst tokens) has a token left. Every summary_interval, a summary of
+// the suppressed counts per site is logged to the sinks: from a timer thread
+// in the _mt variant, on the next message or flush in the _st one.
+
+namespace spdlog {
+namespace sinks {
+
+template<typename Mutex>
+class throttled_sink : public dist_sink<Mutex>
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    throttled_sink(double rate_per_sec, double burst, uint64_t sample_every, std::chrono::seconds summary_interval)
+        : rate_per_sec_(rate_per_sec)
+        , burst_(std::max(burst, 1.0))
+        , sample_every_(std::max<uint64_t>(sample_every, 1))
+        , summary_interval_(summary_interval)
+        , last_summary_(clock::now())
+    {
+        // without a real mutex, the timer thread could not share the sites
+        if (!std::is_same<Mutex, details::null_mutex>::value)
+        {
+            timer_ = std::thread(&throttled_sink::timer_loop_, this);
+        }
+    }
+
+    ~throttled_sink() override
+    {
+        if (timer_.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(timer_mutex_);
+                stop_ = true;
+            }
+            timer_cv_.notify_all();
+            timer_.join();
+        }
+    }
+
+protected:
+    void sink_it_(const details::log_msg &msg) override
+    {
+        const auto now = clock::now();
+        if (admit_(msg, now))
+        {
+            dist_sink<Mutex>::sink_it_(msg);
+        }
+        if (now - last_summary_ >= summary_interval_)
+        {
+            summarize_(now);
+        }
+    }
+
+    void flush_() override
+    {
+        summarize_(clock::now());
+        dist_sink<Mutex>::flush_();
+    }
+
+private:
+    // the source file and line of a call site, or the logger name and level
+    struct site_key
+    {
+        const void *origin;
+        uint32_t line;
+
+        bool operator==(const site_key &other) const
+        {
+            return origin == other.origin && line == other.line;
+        }
+    };
+
+    struct site_key_hash
+    {
+        size_t operator()(const site_key &key) const
+        {
+            return std::hash<const void *>()(key.origin) ^ (static_cast<size_t>(key.line) * 0x9E3779B97F4A7C15ull);
+        }
+    };
+
+    struct site
+    {
+        double tokens;
+        clock::time_point refilled;
+        uint64_t seen;
+        uint64_t suppressed;
+        std::string label;
+    };
+
+    site &find_site_(const details::log_msg &msg, clock::time_point now)
+    {
+        const bool located = !msg.source.empty();
+        const site_key key = located ? site_key{msg.source.filename, static_cast<uint32_t>(msg.source.line)}
+                                     : site_key{msg.logger_name, static_cast<uint32_t>(msg.level)};
+        auto it = sites_.find(key);
+        if (it == sites_.end())
+        {
+            // the label is copied, as the logger may not outlive its site
+            const string_view_t level_name = level::to_string_view(msg.level);
+            std::string label = located ? fmt::format("{}:{}", msg.source.filename, msg.source.line)
+                                        : fmt::format("{}/{}", msg.logger_name != nullptr ? *msg.logger_name : std::string(),
+                                              std::string(level_name.data(), level_name.size()));
+            it = sites_.emplace(key, site{burst_, now, 0, 0, std::move(label)}).first;
+        }
+        return it->second;
+    }
+
+    bool admit_(const details::log_msg &msg, clock::time_point now)
+    {
+        site &s = find_site_(msg, now);
+
+        if (s.seen++ % sample_every_ != 0)
+        {
+            s.suppressed++;
+            return false;
+        }
+        if (rate_per_sec_ <= 0.0)
+        {
+            return true;
+        }
+
+        s.tokens = std::min(burst_, s.tokens + std::chrono::duration<double>(now - s.refilled).count() * rate_per_sec_);
+        s.refilled = now;
+        if (s.tokens < 1.0)
+        {
+            s.suppressed++;
+            return false;
+        }
+        s.tokens -= 1.0;
+        return true;
+    }
+
+    // summarize every interval even when nothing is logged, so the counts of
+    // a burst that stopped are not held back until the next message
+    void timer_loop_()
+    {
+        std::unique_lock<std::mutex> lock(timer_mutex_);
+        while (!timer_cv_.wait_for(lock, summary_interval_, [this] { return stop_; }))
+        {
+            std::lock_guard<Mutex> sink_lock(base_sink<Mutex>::mutex_);
+            const auto now = clock::now();
+            if (now - last_summary_ >= summary_interval_)
+            {
+                summarize_(now);
+            }
+        }
+    }
+
+    // log and reset the suppressed counts, most suppressed sites first
+    void summarize_(clock::time_point now)
+    {
+        static constexpr size_t max_sites_listed = 5;
+        last_summary_ = now;
+
+        std::vector<std::pair<uint64_t, const std::string *>> suppressed;
+        uint64_t total = 0;
+        for (auto &entry : sites_)
+        {
+            if (entry.second.suppressed > 0)
+            {
+                suppressed.emplace_back(entry.second.suppressed, &entry.second.label);
+                total += entry.second.suppressed;
+                entry.second.suppressed = 0;
+            }
+        }
+        if (total == 0)
+        {
+            return;
+        }
+
+        std::sort(suppressed.begin(), suppressed.end(),
+            [](const std::pair<uint64_t, const std::string *> &a, const std::pair<uint64_t, const std::string *> &b) {
+                return a.first > b.first;
+            });
+        fmt::memory_buffer summary;
+        fmt::format_to(summary, "Suppressed {} messages from {} sites:", total, suppressed.size());
+        for (size_t i = 0; i < suppressed.size() && i < max_sites_listed; i++)
+        {
+            fmt::format_to(summary, " {} x{}", *suppressed[i].second, suppressed[i].first);
+        }
+
+        details::log_msg msg(&name_, level::warn, string_view_t(summary.data(), summary.size()));
+        dist_sink<Mutex>::sink_it_(msg);
+    }
+
+    const double rate_per_sec_;
+    const double burst_;
+    const uint64_t sample_every_;
+    const std::chrono::seconds summary_interval_;
+    clock::time_point last_summary_;
+    std::unordered_map<site_key, site, site_key_hash> sites_;
+    const std::string name_ = "throttle";
+
+    std::mutex timer_mutex_;
+    std::condition_variable timer_cv_;
+    bool stop_ = false;
+    std::thread timer_;
+};
+
+using throttled_sink_mt = throttled_sink<std::mutex>;
+using throttled_sink_st = throttled_sink<details::null_mutex>;
+
+} // namespace sinks
+} // namespace spdlog
@@ -150,3 +150,12 @@
 //
 // #define SPDLOG_FUNCTION __PRETTY_FUNCTION__
 ///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// Uncomment to use a bounded lock-free queue in the async thread pool instead
+// of the mutex and condition variable based one. Logging threads never take a
+// lock; with async_overflow_policy::overrun_oldest the newest message is
+// dropped instead of the oldest when the queue is full.
+//
+// #define SPDLOG_LOCK_FREE_QUEUE
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,36 @@
+#include <cstdio>
+#include <string>
+
+#include "TraceDecode.h"
+
+using namespace pid_control;
+
+
+/*
+* Decodes a binary trace written by TraceLog into text, one record per line,
+* prefixed by the seconds elapsed since the first record.
+*/
+int main(int argc, char* argv[])
+{
+    if (argc != 2)
+    {
+        std::fprintf(stderr, "Usage: %s TRACE_FILE\n", argv[0]);
+        return -1;
+    }
+
+    FILE* in = std::fopen(argv[1], "rb");
+    if (in == nullptr)
+    {
+        std::fprintf(stderr, "Could not open %s\n", argv[1]);
+        return -1;
+    }
+
+    std::string error;
+    const bool decoded = DecodeTrace(in, [](const std::string& line) { std::printf("%s\n", line.c_str()); }, error);
+    std::fclose(in);
+    if (not error.empty())
+    {
+        std::fprintf(stderr, "%s: %s\n", argv[1], error.c_str());
+    }
+    return decoded ? 0 : -1;
+}
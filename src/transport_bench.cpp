@@ -0,0 +1,223 @@
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "LatencyHistogram.h"
+#include "Protocol.h"
+#include "ShmChannel.h"
+
+using Clock = std::chrono::steady_clock;
+
+using namespace pid_control;
+
+
+static constexpr unsigned DEFAULT_TICKS = 100000u;
+static constexpr unsigned WARMUP_TICKS = 1000u;
+static constexpr auto SHM_TIMEOUT = std::chrono::seconds(1);
+
+/*
+* Telemetry of a car weaving around the lane center.
+*/
+static Telemetry telemetryAt(unsigned tick)
+{
+    Telemetry telemetry;
+    telemetry.cte = 0.5 * std::sin(0.01 * tick);
+    telemetry.speed = 30.0;
+    return telemetry;
+}
+
+static int connectUnix(const std::string& path)
+{
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path))
+    {
+        return -1;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1u);
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int connectTcp(const std::string& hostPort)
+{
+    const size_t colon = hostPort.rfind(':');
+    if (colon == std::string::npos)
+    {
+        return -1;
+    }
+    addrinfo hints {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(hostPort.substr(0u, colon).c_str(), hostPort.substr(colon + 1u).c_str(), &hints, &addresses) != 0)
+    {
+        return -1;
+    }
+    int fd = -1;
+    for (addrinfo* address = addresses; address != nullptr && fd < 0; address = address->ai_next)
+    {
+        fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (fd >= 0 && connect(fd, address->ai_addr, address->ai_addrlen) != 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    if (fd >= 0)
+    {
+        const int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    }
+    return fd;
+}
+
+static bool readAll(int fd, char* data, size_t length)
+{
+    while (length > 0u)
+    {
+        const ssize_t received = recv(fd, data, length, 0);
+        if (received <= 0)
+        {
+            return false;
+        }
+        data += received;
+        length -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+/*
+* One tick over a STRUCT frame stream: send telemetry, then read frames until the steering command.
+*/
+static bool streamTick(int fd, const Telemetry& telemetry)
+{
+    char frame[STRUCT_TELEMETRY_BYTES] = {static_cast<char>(StructFrameType::TELEMETRY)};
+    const double values[] = {telemetry.cte, telemetry.speed, telemetry.steeringAngle, telemetry.throttle};
+    std::memcpy(frame + STRUCT_HEADER_BYTES, values, sizeof(values));
+    if (send(fd, frame, sizeof(frame), MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(frame)))
+    {
+        return false;
+    }
+
+    for (;;)
+    {
+        char header[STRUCT_HEADER_BYTES];
+        if (not readAll(fd, header, sizeof(header)))
+        {
+            return false;
+        }
+        if (static_cast<uint8_t>(header[0]) == static_cast<uint8_t>(StructFrameType::STEER))
+        {
+            double command[2];
+            return readAll(fd, reinterpret_cast<char*>(command), sizeof(command));
+        }
+        if (static_cast<uint8_t>(header[0]) != static_cast<uint8_t>(StructFrameType::RESET))
+        {
+            return false;
+        }
+    }
+}
+
+/*
+* Plays a simulator against a running pid and reports the round trip from sending telemetry
+* to receiving the steering command, e.g.
+*   pid_transport_bench unix:/tmp/pid.sock
+*   pid_transport_bench tcp:127.0.0.1:4567 (the io_uring transport)
+*   pid_transport_bench shm:pid
+*/
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || argc > 3)
+    {
+        std::fprintf(stderr, "Usage: %s unix:PATH|tcp:HOST:PORT|shm:NAME [TICKS]\n", argv[0]);
+        return -1;
+    }
+    const std::string endpoint = argv[1];
+    const unsigned ticks = argc == 3 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : DEFAULT_TICKS;
+    const size_t colon = endpoint.find(':');
+    const std::string kind = endpoint.substr(0u, colon);
+    const std::string address = colon == std::string::npos ? "" : endpoint.substr(colon + 1u);
+
+    int fd = -1;
+    ShmChannel channel;
+    if (kind == "unix")
+    {
+        fd = connectUnix(address);
+    }
+    else if (kind == "tcp")
+    {
+        fd = connectTcp(address);
+    }
+    else if (kind == "shm")
+    {
+        if (not channel.Open(address))
+        {
+            std::fprintf(stderr, "Could not open shared memory %s: %s\n", address.c_str(), std::strerror(errno));
+            return -1;
+        }
+    }
+    else
+    {
+        std::fprintf(stderr, "Unknown endpoint %s\n", endpoint.c_str());
+        return -1;
+    }
+    if (kind != "shm" && fd < 0)
+    {
+        std::fprintf(stderr, "Could not connect to %s\n", endpoint.c_str());
+        return -1;
+    }
+
+    LatencyHistogram roundTrip;
+    for (unsigned tick = 0u; tick < WARMUP_TICKS + ticks; ++tick)
+    {
+        const Telemetry telemetry = telemetryAt(tick);
+        const auto start = Clock::now();
+        bool ok = true;
+        if (channel.IsOpen())
+        {
+            ShmCommand command;
+            ok = channel.WaitCommand(channel.PublishTelemetry(telemetry), command, SHM_TIMEOUT);
+        }
+        else
+        {
+            ok = streamTick(fd, telemetry);
+        }
+        const auto end = Clock::now();
+        if (not ok)
+        {
+            std::fprintf(stderr, "No steering command for tick %u\n", tick);
+            return -1;
+        }
+        if (tick >= WARMUP_TICKS)
+        {
+            roundTrip.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                end - start).count()));
+        }
+    }
+
+    std::printf("%s round trip over %u ticks: %s\n", kind.c_str(), ticks, roundTrip.Summary().c_str());
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    return 0;
+}
@@ -0,0 +1,480 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "spdlog/spdlog.h"
+
+#include "BayesOpt.h"
+#include "Episode.h"
+#include "GainSchedule.h"
+#include "Hyperband.h"
+#include "Options.h"
+#include "PID.h"
+#include "Track.h"
+#include "Twiddle.h"
+#include "VehicleBatch.h"
+#include "VehicleSim.h"
+
+using namespace pid_control;
+
+
+// Tuner configuration, as in the pid binary
+static constexpr double TWIDDLE_TOLERANCE = 0.02;
+static constexpr double INITIAL_TWIDDLE_COEFF = 0.1;
+static const std::array<double, 3> MAX_TUNED_GAINS {{ 1.0, 0.01, 2.0 }};
+static constexpr unsigned HYPERBAND_ETA = 3u;
+static constexpr double MAX_STEERING_ANGLE = 25.0;
+
+// Headless simulator tick, in seconds
+static constexpr double SIM_DT = 0.05;
+
+// Checkpoints of the reference run are taken this often
+static constexpr unsigned CHECKPOINT_INTERVAL = 25u;
+// How far before the point where the reference run failed to fork from
+static constexpr unsigned FAILURE_LOOKBACK = 50u;
+
+/*
+* Calls `task` for every index in [0, count) on up to one thread per core.
+*/
+static void parallelFor(size_t count, const std::function<void(size_t)>& task)
+{
+    const size_t workers = std::min<size_t>(count, std::max(std::thread::hardware_concurrency(), 1u));
+    std::atomic<size_t> next(0u);
+    std::vector<std::thread> threads;
+    for (size_t w = 0u; w < workers; ++w)
+    {
+        threads.emplace_back([&]()
+        {
+            for (size_t i = next++; i < count; i = next++)
+            {
+                task(i);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+static std::unique_ptr<Tuner> makeTuner(const Options& options, size_t paramCount, unsigned minTicks, unsigned maxTicks)
+{
+    std::vector<double> lower(paramCount, 0.0);
+    std::vector<double> upper(paramCount);
+    for (size_t i = 0; i < paramCount; ++i)
+    {
+        upper[i] = MAX_TUNED_GAINS[i % MAX_TUNED_GAINS.size()];
+    }
+
+    if (options.tuner == "bayes")
+    {
+        return std::unique_ptr<Tuner>(new BayesOpt(lower, upper, options.tunerBudget, options.bayesBatch, options.seed));
+    }
+    if (options.tuner == "hyperband")
+    {
+        return std::unique_ptr<Tuner>(new Hyperband(lower, upper, minTicks, maxTicks, HYPERBAND_ETA, options.seed));
+    }
+    std::unique_ptr<Twiddle> twiddle(new Twiddle(TWIDDLE_TOLERANCE));
+    twiddle->SetCoefficients(std::vector<double>(paramCount, INITIAL_TWIDDLE_COEFF));
+    return std::move(twiddle);
+}
+
+/*
+* Drives `sim` from its current state with `params`: the gains of a single PID, or with a gain schedule,
+* of every schedule node.
+*/
+static EpisodeResult drive(VehicleSim& sim, const std::vector<double>& params, const Options& options,
+                           const EpisodeLimits& limits,
+                           const std::function<void(const VehicleSim&)>& onTick = nullptr)
+{
+    PID pid(params[0], params[1], params[2]);
+    pid.Reset(sim.Cte());
+    if (options.scheduleSpeedNodes == 0u)
+    {
+        return RunEpisode(sim, pid, options.throttle, limits, onTick);
+    }
+    GainSchedule schedule(options.scheduleSpeedNodes, options.scheduleMaxSpeed, options.scheduleCurvatureNodes,
+                          MAX_STEERING_ANGLE, {0.0, 0.0, 0.0});
+    schedule.UpdateParams(params);
+    return RunEpisode(sim, pid, options.throttle, limits, onTick, &schedule);
+}
+
+/*
+* Runs `params` from the track start, with the noise of episode `seed`. Every tick simulated is added to `ticks`.
+*/
+static EpisodeResult runFromStart(const Track& track, const std::vector<double>& params, const Options& options,
+                                  const EpisodeLimits& limits, uint64_t seed, uint64_t& ticks,
+                                  const std::function<void(const VehicleSim&)>& onTick = nullptr)
+{
+    VehicleSim sim(track, SIM_DT, options.noise, seed);
+    const EpisodeResult result = drive(sim, params, options, limits, onTick);
+    ticks += result.ticks;
+    return result;
+}
+
+/*
+* Picks the states to fork candidate episodes from: a reference run with `params` is checkpointed regularly,
+* and the checkpoints followed by the largest CTE within `horizon` ticks are kept, along with the one just before
+* the run failed and the track start (the launch from standstill behaves unlike anything else on the track).
+*/
+static std::vector<VehicleState> collectCheckpoints(const Track& track, const std::vector<double>& params,
+                                                    const Options& options, const EpisodeLimits& limits,
+                                                    unsigned horizon, uint64_t& ticks)
+{
+    std::vector<VehicleState> states;
+    std::vector<double> peakCte;  // Peak CTE between each state and the horizon after it
+    // The reference run is noise-free: the snapshots are replayed under every episode's noise
+    Options noiseFree = options;
+    noiseFree.noise = NoiseConfig();
+    const EpisodeResult reference = runFromStart(track, params, noiseFree, limits, 0u, ticks,
+                                                 [&](const VehicleSim& sim)
+    {
+        if (sim.Tick() % CHECKPOINT_INTERVAL == 0u)
+        {
+            states.push_back(sim.Snapshot());
+            peakCte.push_back(0.0);
+        }
+        for (size_t i = states.size(); i-- > 0u && sim.Tick() - states[i].tick <= horizon;)
+        {
+            peakCte[i] = std::max(peakCte[i], std::abs(sim.TrueCte()));
+        }
+    });
+
+    std::vector<size_t> order(states.size());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return peakCte[a] > peakCte[b]; });
+
+    VehicleSim start(track, SIM_DT);
+    std::vector<VehicleState> checkpoints {start.Snapshot()};
+    if (reference.failed && not states.empty())
+    {
+        const unsigned target = reference.ticks > FAILURE_LOOKBACK ? reference.ticks - FAILURE_LOOKBACK : 0u;
+        const auto before = std::find_if(states.rbegin(), states.rend(),
+                                         [&](const VehicleState& s) { return s.tick <= target; });
+        checkpoints.push_back(before != states.rend() ? *before : states.front());
+    }
+    for (size_t i = 0; i < order.size() && checkpoints.size() < options.checkpoints; ++i)
+    {
+        const auto& state = states[order[i]];
+        if (std::none_of(checkpoints.begin(), checkpoints.end(), [&](const VehicleState& s) { return s.tick == state.tick; }))
+        {
+            checkpoints.push_back(state);
+        }
+    }
+    return checkpoints;
+}
+
+/*
+* Sum of the errors of `params` driving from every checkpoint, with the noise of episode `seed`.
+*/
+static double evaluateForks(const Track& track, const std::vector<double>& params,
+                            const std::vector<VehicleState>& checkpoints, const Options& options,
+                            const EpisodeLimits& limits, uint64_t seed, uint64_t& ticks)
+{
+    VehicleSim sim(track, SIM_DT, options.noise, seed);
+    double error = 0.0;
+    for (const auto& checkpoint : checkpoints)
+    {
+        sim.Restore(checkpoint);
+        const EpisodeResult result = drive(sim, params, options, limits);
+        ticks += result.ticks;
+        error += result.Error(limits);
+    }
+    return error;
+}
+
+/*
+* The `bank`th set of `mcSeeds` episode seeds.
+*/
+static std::vector<uint64_t> seedBank(const Options& options, uint64_t bank)
+{
+    std::vector<uint64_t> seeds(options.mcSeeds);
+    for (size_t k = 0u; k < seeds.size(); ++k)
+    {
+        seeds[k] = (uint64_t(options.seed) << 32u) + bank * options.mcSeeds + k;
+    }
+    return seeds;
+}
+
+/*
+* Episode seeds for one evaluation: a single noise-free episode, or a set of randomized ones.
+* Fresh seeds are never handed out twice. Otherwise, with common random numbers every candidate is driven
+* through the same bank of seeds, so the tuner compares gains on identical disturbances rather than on
+* different noise realizations; as the noise is drawn per tick, the streams stay aligned however far
+* the candidates' trajectories diverge.
+*/
+static std::vector<uint64_t> drawSeeds(const Options& options, bool fresh = false)
+{
+    static constexpr uint64_t COMMON_BANK = 0u;
+    static uint64_t nextBank = COMMON_BANK + 1u;
+    if (not options.noise.Enabled())
+    {
+        return {0u};
+    }
+    if (options.commonRandomNumbers && not fresh)
+    {
+        return seedBank(options, COMMON_BANK);
+    }
+    return seedBank(options, nextBank++);
+}
+
+/*
+* Cost of a gain set over all its Monte Carlo episodes.
+*/
+struct Cost
+{
+    double mean { 0.0 };
+    double worst { 0.0 };
+    size_t failures { 0u };
+    size_t episodes { 0u };
+
+    double Objective(const Options& options) const { return options.mcWorstCase ? worst : mean; };
+};
+
+/*
+* Error of `params` on every track under every seed, the episodes in parallel: full runs from the start,
+* or forks from each track's checkpoints in fork mode.
+*/
+static Cost evaluateOnTracks(const std::vector<Track>& tracks, const std::vector<std::vector<VehicleState>>& checkpoints,
+                             const std::vector<double>& params, const Options& options, const EpisodeLimits& limits,
+                             const std::vector<uint64_t>& seeds, uint64_t& ticks)
+{
+    const size_t episodes = tracks.size() * seeds.size();
+    std::vector<double> errors(episodes);
+    std::vector<uint64_t> episodeTicks(episodes, 0u);
+    std::vector<char> failed(episodes, false);
+    parallelFor(episodes, [&](size_t e)
+    {
+        const size_t t = e / seeds.size();
+        const uint64_t seed = seeds[e % seeds.size()];
+        if (options.fork)
+        {
+            errors[e] = evaluateForks(tracks[t], params, checkpoints[t], options, limits, seed, episodeTicks[e]);
+            return;
+        }
+        const EpisodeResult result = runFromStart(tracks[t], params, options, limits, seed, episodeTicks[e]);
+        errors[e] = result.Error(limits);
+        failed[e] = result.failed;
+    });
+    ticks += std::accumulate(episodeTicks.begin(), episodeTicks.end(), uint64_t(0u));
+
+    Cost cost;
+    cost.episodes = episodes;
+    cost.mean = std::accumulate(errors.begin(), errors.end(), 0.0) / episodes;
+    cost.worst = *std::max_element(errors.begin(), errors.end());
+    cost.failures = std::count(failed.begin(), failed.end(), true);
+    return cost;
+}
+
+/*
+* Full runs of `params` on every track; logs them and returns how many were completed.
+* With noise enabled, also logs the Monte Carlo cost of every track over fresh seeds.
+*/
+static size_t validate(const std::vector<Track>& tracks, const std::vector<double>& params, const Options& options,
+                       const EpisodeLimits& limits, uint64_t& ticks)
+{
+    Options noiseFree = options;
+    noiseFree.noise = NoiseConfig();
+    const std::vector<uint64_t> seeds = drawSeeds(options, true);
+
+    size_t completed = 0u;
+    for (size_t t = 0u; t < tracks.size(); ++t)
+    {
+        const EpisodeResult result = runFromStart(tracks[t], params, noiseFree, limits, 0u, ticks);
+        spdlog::info("Track {}: full run {} ticks (mean |CTE| {:.3f}{})",
+                     t, result.ticks, result.meanAbsCte, result.failed ? ", failed" : "");
+        completed += not result.failed;
+
+        if (options.noise.Enabled())
+        {
+            Options full = options;
+            full.fork = false;
+            const Cost cost = evaluateOnTracks({tracks[t]}, {}, params, full, limits, seeds, ticks);
+            // Reported as ticks short of a full run plus the CTE tie-breaker: below 1 means completed
+            const double offset = static_cast<double>(std::numeric_limits<unsigned>::max() - limits.maxTicks);
+            spdlog::info("Track {}: {} randomized runs, cost mean {:.3f} worst {:.3f}, {} failed",
+                         t, cost.episodes, cost.mean - offset, cost.worst - offset, cost.failures);
+        }
+    }
+    return completed;
+}
+
+/*
+* Runs `cars` random gain sets in one VehicleBatch and reports the throughput.
+*/
+static void benchmarkBatch(const Track& track, const Options& options, const EpisodeLimits& limits, unsigned cars)
+{
+    std::mt19937 rng(options.seed);
+    VehicleBatch batch(track, SIM_DT, cars);
+    for (unsigned i = 0u; i < cars; ++i)
+    {
+        std::uniform_real_distribution<double> kp(0.0, MAX_TUNED_GAINS[0]);
+        std::uniform_real_distribution<double> ki(0.0, MAX_TUNED_GAINS[1]);
+        std::uniform_real_distribution<double> kd(0.0, MAX_TUNED_GAINS[2]);
+        batch.SetGains(i, kp(rng), ki(rng), kd(rng));
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const size_t vehicleTicks = batch.Run(options.throttle, limits);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    spdlog::info("{} cars: {} vehicle-ticks in {:.3f}s, {:.0f} vehicle-ticks/s",
+                 cars, vehicleTicks, seconds, vehicleTicks / seconds);
+}
+
+/*
+* Bayesian optimization with each batch of suggestions driven in lockstep by one VehicleBatch per track,
+* the tracks in parallel.
+*/
+static std::vector<double> tuneBayesBatched(const std::vector<Track>& tracks, const Options& options,
+                                            const EpisodeLimits& limits, std::vector<double> params, uint64_t& ticks)
+{
+    std::vector<double> lower(params.size(), 0.0);
+    std::vector<double> upper(params.size());
+    for (size_t i = 0; i < params.size(); ++i)
+    {
+        upper[i] = MAX_TUNED_GAINS[i % MAX_TUNED_GAINS.size()];
+    }
+    BayesOpt bayesOpt(lower, upper, options.tunerBudget, options.bayesBatch, options.seed);
+    bayesOpt.AddObservation(params, evaluateOnTracks(tracks, {}, params, options, limits, drawSeeds(options), ticks).mean);
+
+    while (bayesOpt.GetEvaluations() < options.tunerBudget)
+    {
+        const auto suggestions = bayesOpt.SuggestBatch();
+        std::vector<std::vector<double>> errors(tracks.size(), std::vector<double>(suggestions.size()));
+        std::vector<uint64_t> trackTicks(tracks.size(), 0u);
+        parallelFor(tracks.size(), [&](size_t t)
+        {
+            VehicleBatch batch(tracks[t], SIM_DT, suggestions.size());
+            for (size_t i = 0; i < suggestions.size(); ++i)
+            {
+                batch.SetGains(i, suggestions[i][0], suggestions[i][1], suggestions[i][2]);
+            }
+            trackTicks[t] = batch.Run(options.throttle, limits);
+            for (size_t i = 0; i < suggestions.size(); ++i)
+            {
+                errors[t][i] = batch.Result(i, limits).Error(limits);
+            }
+        });
+        ticks += std::accumulate(trackTicks.begin(), trackTicks.end(), uint64_t(0u));
+
+        for (size_t i = 0; i < suggestions.size(); ++i)
+        {
+            double error = 0.0;
+            for (const auto& trackErrors : errors)
+            {
+                error += trackErrors[i];
+            }
+            bayesOpt.AddObservation(suggestions[i], error / tracks.size());
+        }
+    }
+    return bayesOpt.GetBestParams();
+}
+
+int main(int argc, char* argv[])
+{
+    spdlog::set_level(static_cast<spdlog::level::level_enum>(SPDLOG_ACTIVE_LEVEL));
+
+    Options options;
+    if (not ParseOptions(argc, argv, options))
+    {
+        return -1;
+    }
+
+    // The built-in track, or a set of generated ones to tune gains that do not overfit a single layout
+    std::vector<Track> tracks;
+    if (options.tracks <= 1u)
+    {
+        tracks.push_back(Track::Default());
+    }
+    for (unsigned t = 0u; options.tracks > 1u && t < options.tracks; ++t)
+    {
+        tracks.push_back(Track::Generate(options.seed + t));
+    }
+
+    const EpisodeLimits fullLimits;
+    const unsigned minTicks = std::max(options.hyperbandMinTicks, fullLimits.graceTicks);
+
+    std::vector<double> params {0.0, 0.0, 0.0};
+    if (options.scheduleSpeedNodes > 0u)
+    {
+        // The tuner tunes the gains of every schedule node instead of a single PID
+        params = GainSchedule(options.scheduleSpeedNodes, options.scheduleMaxSpeed, options.scheduleCurvatureNodes,
+                              MAX_STEERING_ANGLE, {0.0, 0.0, 0.0}).GetParams();
+        spdlog::info("Scheduling gains over {} speed and {} curvature nodes",
+                     options.scheduleSpeedNodes, options.scheduleCurvatureNodes);
+    }
+    uint64_t ticks = 0u;
+
+    if (options.benchCars > 0u)
+    {
+        benchmarkBatch(tracks.front(), options, fullLimits, options.benchCars);
+        return 0;
+    }
+
+    // VehicleBatch has no noise model or gain schedule, so randomized and scheduled runs take the generic path
+    if (options.tuner == "bayes" && not options.fork && not options.noise.Enabled() && options.scheduleSpeedNodes == 0u)
+    {
+        params = tuneBayesBatched(tracks, options, fullLimits, params, ticks);
+        const size_t completed = validate(tracks, params, options, fullLimits, ticks);
+        spdlog::warn("Final params: {}, completed {}/{} tracks", fmt::join(params, ", "), completed, tracks.size());
+        spdlog::info("Simulated {} ticks in total", ticks);
+        return 0;
+    }
+
+    const unsigned rounds = options.fork ? std::max(options.forkRounds, 1u) : 1u;
+    for (unsigned round = 0u; round < rounds; ++round)
+    {
+        std::vector<std::vector<VehicleState>> checkpoints(tracks.size());
+        if (options.fork)
+        {
+            for (size_t t = 0u; t < tracks.size(); ++t)
+            {
+                checkpoints[t] = collectCheckpoints(tracks[t], params, options, fullLimits, options.forkTicks, ticks);
+            }
+            spdlog::info("Round {}: forking from {} checkpoints per track", round, checkpoints.front().size());
+        }
+
+        const unsigned maxTicks = options.fork ? options.forkTicks : fullLimits.maxTicks;
+        if (round == 0u && options.tuner == "hyperband" && maxTicks / HYPERBAND_ETA < minTicks)
+        {
+            spdlog::warn("Episodes of {} ticks leave no room for Hyperband rungs of at least {} ticks, "
+                         "running a single halving round from {} ticks", maxTicks, minTicks, maxTicks / HYPERBAND_ETA);
+        }
+        auto tuner = makeTuner(options, params.size(), std::min(minTicks, maxTicks), maxTicks);
+
+        unsigned episodes = 0u;
+        bool done = false;
+        while (not done)
+        {
+            EpisodeLimits limits = fullLimits;
+            limits.maxTicks = tuner->GetEpisodeTicks(maxTicks);
+
+            const Cost cost = evaluateOnTracks(tracks, checkpoints, params, options, limits, drawSeeds(options), ticks);
+            SPDLOG_DEBUG("Params {}: cost mean {} worst {} over {} episodes",
+                         fmt::join(params, ", "), cost.mean, cost.worst, cost.episodes);
+            done = tuner->runOnce(cost.Objective(options), params);
+            episodes++;
+        }
+
+        const size_t completed = validate(tracks, params, options, fullLimits, ticks);
+        spdlog::info("Round {}: {} evaluations, params {}, completed {}/{} tracks",
+                     round, episodes, fmt::join(params, ", "), completed, tracks.size());
+    }
+
+    spdlog::warn("Final params: {}", fmt::join(params, ", "));
+    spdlog::info("Simulated {} ticks in total", ticks);
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "AdaptiveTuner.h"
+
+using namespace pid_control;
+
+
+// Plant identified by the tests: cte[k+1] = A1 cte[k] + A2 cte[k-1] + B steering[k]
+static constexpr double A1 = 1.9;
+static constexpr double A2 = -0.9;
+static constexpr double B = 0.1;
+
+/*
+* Drives the plant for `ticks` ticks with the PD gains `params`, adapting them, from an initial error.
+*/
+static double drive(AdaptiveTuner& adaptive, std::vector<double>& params, unsigned ticks)
+{
+    double cte = 0.5;
+    double prevCte = cte;
+    double maxCte = 0.0;
+    for (unsigned k = 0u; k < ticks; ++k)
+    {
+        adaptive.Observe(cte);
+        adaptive.UpdateGains(params);
+        const double steering = adaptive.Excite(-params[0] * cte - params[2] * (cte - prevCte));
+        adaptive.OnCommand(steering);
+
+        const double next = A1 * cte + A2 * prevCte + B * steering;
+        prevCte = cte;
+        cte = next;
+        maxCte = std::max(maxCte, std::abs(cte));
+    }
+    return maxCte;
+}
+
+TEST(AdaptiveTuner, IdentifiesThePlant)
+{
+    AdaptiveTuner adaptive(0.995, 0.9, 0.01, 5.0, 0.02);
+    std::vector<double> params {0.5, 0.0, 2.0};
+    drive(adaptive, params, 2000u);
+
+    const auto model = adaptive.GetModel();
+    EXPECT_NEAR(A1, model[0], 1e-3);
+    EXPECT_NEAR(A2, model[1], 1e-3);
+    EXPECT_NEAR(B, model[2], 1e-3);
+}
+
+TEST(AdaptiveTuner, MovesGainsTowardsThePolePlacement)
+{
+    AdaptiveTuner adaptive(0.995, 0.9, 0.01, 5.0, 0.02);
+    std::vector<double> params {0.5, 0.0, 2.0};
+    const double maxCte = drive(adaptive, params, 5000u);
+    EXPECT_LT(maxCte, 1.0);
+
+    // Double closed loop pole at p: kd = -(p^2 + a2) / b, kp = (a1 - 2p) / b - kd
+    const double kd = -(0.81 + A2) / B;
+    const double kp = (A1 - 1.8) / B - kd;
+    EXPECT_NEAR(kp, params[0], 0.05);
+    EXPECT_NEAR(kd, params[2], 0.05);
+}
+
+TEST(AdaptiveTuner, RestartKeepsTheModel)
+{
+    AdaptiveTuner adaptive(0.995, 0.9, 0.01, 5.0, 0.02);
+    std::vector<double> params {0.5, 0.0, 2.0};
+    drive(adaptive, params, 2000u);
+    const auto model = adaptive.GetModel();
+
+    // A reset jumps the CTE; without a restart that jump would be fitted as plant dynamics
+    adaptive.Restart();
+    adaptive.Observe(2.0);
+    adaptive.OnCommand(0.0);
+    adaptive.Observe(0.0);
+    EXPECT_EQ(model, adaptive.GetModel());
+}
@@ -0,0 +1,132 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "Arena.h"
+#include "FastJson.h"
+
+using namespace pid_control;
+
+
+// Heap allocations of the whole test program, counted by the replaced operator new
+static std::atomic<uint64_t> allocations { 0u };
+
+void* operator new(size_t bytes)
+{
+    allocations.fetch_add(1u, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(bytes == 0u ? 1u : bytes))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+static bool isAligned(const void* pointer, size_t alignment)
+{
+    return reinterpret_cast<uintptr_t>(pointer) % alignment == 0u;
+}
+
+TEST(Arena, BumpsAlignedPointers)
+{
+    Arena arena(256u);
+    char* first = static_cast<char*>(arena.Allocate(1u, 1u));
+    char* second = static_cast<char*>(arena.Allocate(8u, 8u));
+    char* third = static_cast<char*>(arena.Allocate(4u, 16u));
+    EXPECT_TRUE(arena.Owns(first));
+    EXPECT_TRUE(arena.Owns(second));
+    EXPECT_TRUE(arena.Owns(third));
+    EXPECT_TRUE(isAligned(second, 8u));
+    EXPECT_TRUE(isAligned(third, 16u));
+    EXPECT_LT(first, second);
+    EXPECT_LE(second + 8, third);
+    EXPECT_EQ(static_cast<size_t>(third + 4 - first), arena.Used());
+    EXPECT_EQ(0u, arena.Overflows());
+}
+
+TEST(Arena, OverflowsToTheHeap)
+{
+    Arena arena(64u);
+    void* inside = arena.Allocate(48u, 8u);
+    const uint64_t before = allocations.load();
+    void* outside = arena.Allocate(32u, 8u);
+    EXPECT_EQ(before + 1u, allocations.load());
+    EXPECT_TRUE(arena.Owns(inside));
+    EXPECT_FALSE(arena.Owns(outside));
+    EXPECT_EQ(1u, arena.Overflows());
+    EXPECT_EQ(48u, arena.Used());
+
+    // Freed on the heap, the arena is unchanged
+    arena.Deallocate(outside);
+    arena.Deallocate(inside);
+    EXPECT_EQ(48u, arena.Used());
+}
+
+TEST(Arena, ResetKeepsTheHighWater)
+{
+    Arena arena(256u);
+    void* pointer = arena.Allocate(100u, 1u);
+    arena.Deallocate(pointer);
+    arena.Reset();
+    EXPECT_EQ(0u, arena.Used());
+    EXPECT_EQ(100u, arena.HighWater());
+
+    EXPECT_EQ(pointer, arena.Allocate(10u, 1u));
+    EXPECT_EQ(10u, arena.Used());
+    EXPECT_EQ(100u, arena.HighWater());
+}
+
+TEST(Arena, AllocatorFreesHeapValuesThroughTheCurrentArena)
+{
+    Arena arena(256u);
+    {
+        // Allocated on the heap, destroyed while an arena is current
+        std::vector<int, ArenaAllocator<int>> values(4u, 1);
+        Arena::SetCurrent(&arena);
+    }
+    EXPECT_EQ(0u, arena.Used());
+    {
+        std::vector<int, ArenaAllocator<int>> values(4u, 1);
+        EXPECT_TRUE(arena.Owns(values.data()));
+    }
+    Arena::SetCurrent(nullptr);
+    arena.Reset();
+}
+
+TEST(Arena, ParsesTelemetryWithoutTheHeap)
+{
+    const std::string frame =
+        "{\"cte\":\"0.7598\",\"speed\":\"28.3201\",\"steering_angle\":\"-1.8457\",\"throttle\":\"0.3000\"}";
+    Arena arena(64u * 1024u);
+    Arena::SetCurrent(&arena);
+
+    double cte = 0.0;
+    const uint64_t before = allocations.load();
+    {
+        ArenaResetGuard reset(arena);
+        auto data = fast_json::parse(frame.data(), frame.data() + frame.size());
+        cte = std::stod(data["cte"].get_ref<const std::string&>());
+    }
+    const uint64_t allocated = allocations.load() - before;
+
+    Arena::SetCurrent(nullptr);
+    EXPECT_EQ(0u, allocated);
+    EXPECT_EQ(0.7598, cte);
+    EXPECT_EQ(0u, arena.Overflows());
+    EXPECT_GT(arena.HighWater(), 0u);
+    EXPECT_EQ(0u, arena.Used());
+}
@@ -0,0 +1,133 @@
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "BayesOpt.h"
+#include "GaussianProcess.h"
+
+using namespace pid_control;
+
+
+static const std::vector<std::vector<double>> POINTS {{0.1, 0.2}, {0.4, 0.9}, {0.7, 0.3}, {0.95, 0.6}, {0.5, 0.5}};
+static const std::vector<double> VALUES {3.0, -1.0, 2.5, 0.0, 1.0};
+
+static double kernel(const std::vector<double>& a, const std::vector<double>& b, double lengthScale)
+{
+    const double distance = (a[0] - b[0]) * (a[0] - b[0]) + (a[1] - b[1]) * (a[1] - b[1]);
+    return std::exp(-0.5 * distance / (lengthScale * lengthScale));
+}
+
+TEST(GaussianProcess, CholeskyReconstructsTheKernelMatrix)
+{
+    const double noise = 0.01;
+    const GaussianProcess gp(POINTS, VALUES, 0.25, noise);
+    const auto& chol = gp.GetCholesky();
+    ASSERT_EQ(POINTS.size(), chol.size());
+
+    for (size_t i = 0; i < POINTS.size(); ++i)
+    {
+        for (size_t j = 0; j < POINTS.size(); ++j)
+        {
+            if (j > i)
+            {
+                EXPECT_EQ(0.0, chol[i][j]);
+            }
+            double product = 0.0;
+            for (size_t k = 0; k < POINTS.size(); ++k)
+            {
+                product += chol[i][k] * chol[j][k];
+            }
+            EXPECT_NEAR(kernel(POINTS[i], POINTS[j], 0.25) + (i == j ? noise : 0.0), product, 1e-12);
+        }
+    }
+}
+
+TEST(GaussianProcess, InterpolatesObservations)
+{
+    const GaussianProcess gp(POINTS, VALUES, 0.25, 1e-6);
+    for (size_t i = 0; i < POINTS.size(); ++i)
+    {
+        double mean, stddev;
+        gp.Predict(POINTS[i], mean, stddev);
+        EXPECT_NEAR(gp.Standardize(VALUES[i]), mean, 1e-3);
+        EXPECT_LT(stddev, 1e-2);
+    }
+
+    // Far from every observation the prior remains: zero mean, unit deviation
+    double mean, stddev;
+    gp.Predict({10.0, 10.0}, mean, stddev);
+    EXPECT_NEAR(0.0, mean, 1e-9);
+    EXPECT_NEAR(1.0, stddev, 1e-9);
+}
+
+TEST(GaussianProcess, ExpectedImprovement)
+{
+    // Without uncertainty, the improvement itself, or none
+    EXPECT_NEAR(0.9, ExpectedImprovement(1.0, 0.0, 1e-9, 0.1), 1e-9);
+    EXPECT_NEAR(0.0, ExpectedImprovement(0.0, 1.0, 1e-9, 0.0), 1e-9);
+
+    // At the best value, sigma * pdf(0)
+    EXPECT_NEAR(2.0 / std::sqrt(2.0 * M_PI), ExpectedImprovement(0.0, 0.0, 2.0, 0.0), 1e-12);
+
+    // Positive, decreasing with the mean and increasing with the uncertainty
+    double previous = ExpectedImprovement(0.0, -3.0, 1.0, 0.01);
+    for (double mean = -2.5; mean <= 3.0; mean += 0.5)
+    {
+        const double improvement = ExpectedImprovement(0.0, mean, 1.0, 0.01);
+        EXPECT_GT(improvement, 0.0);
+        EXPECT_LT(improvement, previous);
+        EXPECT_GT(ExpectedImprovement(0.0, mean, 1.5, 0.01), improvement);
+        previous = improvement;
+    }
+}
+
+TEST(BayesOpt, FindsTheMinimumOfABowl)
+{
+    const auto bowl = [](const std::vector<double>& p)
+    {
+        return (p[0] - 0.3) * (p[0] - 0.3) + (p[1] - 1.2) * (p[1] - 1.2);
+    };
+
+    BayesOpt bayesOpt({0.0, 0.0}, {1.0, 2.0}, 40u, 2u, 7u);
+    std::vector<double> params {0.9, 0.1};
+    double bestSeen = bowl(params);
+    unsigned evaluations = 0u;
+    bool done = false;
+    while (not done)
+    {
+        const double error = bowl(params);
+        bestSeen = std::min(bestSeen, error);
+        done = bayesOpt.runOnce(error, params);
+        evaluations++;
+        for (size_t i = 0; i < params.size(); ++i)
+        {
+            EXPECT_GE(params[i], 0.0);
+            EXPECT_LE(params[i], i == 0 ? 1.0 : 2.0);
+        }
+    }
+
+    EXPECT_EQ(40u, evaluations);
+    EXPECT_EQ(40u, bayesOpt.GetEvaluations());
+    // On completion the params are the incumbent
+    EXPECT_EQ(bayesOpt.GetBestParams(), params);
+    EXPECT_DOUBLE_EQ(bestSeen, bayesOpt.GetBestError());
+    EXPECT_LT(bayesOpt.GetBestError(), 0.01);
+}
+
+TEST(BayesOpt, IncumbentIsTheBestObservation)
+{
+    BayesOpt bayesOpt({0.0}, {1.0}, 10u, 1u, 1u);
+    EXPECT_TRUE(bayesOpt.GetBestParams().empty());
+
+    bayesOpt.AddObservation({0.5}, 2.0);
+    bayesOpt.AddObservation({0.2}, 1.0);
+    bayesOpt.AddObservation({0.9}, 3.0);
+    EXPECT_EQ(std::vector<double>{0.2}, bayesOpt.GetBestParams());
+    EXPECT_EQ(1.0, bayesOpt.GetBestError());
+
+    // runOnce hands back the next suggestion, while the incumbent stays the best evaluated one
+    std::vector<double> params {0.7};
+    EXPECT_FALSE(bayesOpt.runOnce(5.0, params));
+    EXPECT_EQ(std::vector<double>{0.2}, bayesOpt.GetBestParams());
+}
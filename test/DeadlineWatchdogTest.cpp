@@ -0,0 +1,38 @@
+#include <chrono>
+
+#include "gtest/gtest.h"
+
+#include "DeadlineWatchdog.h"
+
+using namespace pid_control;
+using Clock = DeadlineWatchdog::Clock;
+
+
+TEST(DeadlineWatchdog, DisabledWithoutBudget)
+{
+    DeadlineWatchdog watchdog(0u);
+    const auto arrival = Clock::now();
+    EXPECT_FALSE(watchdog.Enabled());
+    EXPECT_FALSE(watchdog.Expired(arrival, arrival + std::chrono::seconds(1)));
+    EXPECT_FALSE(watchdog.Finish(arrival, arrival + std::chrono::seconds(1)));
+    EXPECT_EQ(0u, watchdog.Ticks());
+}
+
+TEST(DeadlineWatchdog, CountsMissesPerWindow)
+{
+    DeadlineWatchdog watchdog(1000u);
+    const auto arrival = Clock::now();
+    EXPECT_FALSE(watchdog.Expired(arrival, arrival + std::chrono::nanoseconds(1000)));
+    EXPECT_TRUE(watchdog.Expired(arrival, arrival + std::chrono::nanoseconds(1001)));
+
+    EXPECT_FALSE(watchdog.Finish(arrival, arrival + std::chrono::nanoseconds(500)));
+    EXPECT_TRUE(watchdog.Finish(arrival, arrival + std::chrono::nanoseconds(3000)));
+    EXPECT_EQ(2u, watchdog.Ticks());
+    EXPECT_EQ(1u, watchdog.Misses());
+    EXPECT_EQ(2u, watchdog.WindowTicks());
+
+    watchdog.ResetWindow();
+    EXPECT_EQ(0u, watchdog.WindowTicks());
+    EXPECT_EQ(2u, watchdog.Ticks());
+    EXPECT_EQ(1u, watchdog.Misses());
+}
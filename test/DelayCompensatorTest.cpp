@@ -0,0 +1,68 @@
+#include <chrono>
+
+#include "gtest/gtest.h"
+
+#include "DelayCompensator.h"
+
+using namespace pid_control;
+using Clock = DelayCompensator::Clock;
+
+
+static constexpr double TOLERANCE = 1e-9;
+
+static Clock::time_point at(double seconds)
+{
+    return Clock::time_point() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+}
+
+TEST(DelayCompensator, AveragesTheDelayFromCommandToTelemetry)
+{
+    DelayCompensator compensator(1.0, 0.5);
+    compensator.OnTelemetry(at(1.0));
+    EXPECT_EQ(0.0, compensator.DelaySeconds());
+
+    // The first sample is taken as is
+    compensator.OnCommand(at(1.0), 0.0);
+    compensator.OnTelemetry(at(1.1));
+    EXPECT_NEAR(0.1, compensator.DelaySeconds(), TOLERANCE);
+
+    // Later ones are blended in; telemetry without a new command is not a sample
+    compensator.OnCommand(at(1.2), 0.0);
+    compensator.OnTelemetry(at(1.5));
+    EXPECT_NEAR(0.2, compensator.DelaySeconds(), TOLERANCE);
+    compensator.OnTelemetry(at(2.5));
+    EXPECT_NEAR(0.2, compensator.DelaySeconds(), TOLERANCE);
+
+    compensator.Reset();
+    EXPECT_EQ(0.0, compensator.DelaySeconds());
+}
+
+TEST(DelayCompensator, PredictsNothingWithoutDelay)
+{
+    DelayCompensator compensator(2.0, 1.0);
+    compensator.OnCommand(at(1.0), 0.5);
+    EXPECT_EQ(0.7, compensator.Predict(0.7, 30.0, at(1.0)));
+}
+
+TEST(DelayCompensator, IntegratesTheUnseenCommands)
+{
+    static constexpr double GAIN = 2.0;
+    static constexpr double SPEED = 10.0;
+    DelayCompensator compensator(GAIN, 1.0);
+
+    // A delay of 0.3s
+    compensator.OnCommand(at(0.0), 0.0);
+    compensator.OnTelemetry(at(0.3));
+    ASSERT_NEAR(0.3, compensator.DelaySeconds(), TOLERANCE);
+
+    // Commands at 0.4s, 0.6s and 0.8s, telemetry at 0.9s: the window is [0.6s, 0.9s].
+    // The 0.4s command acts until 0.6s, outside of it; 0.6s acts for 0.2s and 0.8s for 0.1s.
+    compensator.OnCommand(at(0.4), 1.0);
+    compensator.OnCommand(at(0.6), 0.5);
+    compensator.OnCommand(at(0.8), -0.25);
+    const double unseen = 0.5 * 0.2 - 0.25 * 0.1;
+    EXPECT_NEAR(1.0 + GAIN * SPEED * unseen, compensator.Predict(1.0, SPEED, at(0.9)), 1e-6);
+
+    // A command sent before the window acts over its part of it
+    EXPECT_NEAR(-1.0 + GAIN * SPEED * (1.0 * 0.1 + 0.5 * 0.2), compensator.Predict(-1.0, SPEED, at(0.8)), 1e-6);
+}
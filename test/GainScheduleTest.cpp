@@ -0,0 +1,73 @@
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "GainSchedule.h"
+
+using namespace pid_control;
+
+
+static constexpr double TOLERANCE = 1e-12;
+static constexpr double NAN_VALUE = std::numeric_limits<double>::quiet_NaN();
+
+/*
+* Speed nodes at 0 and 100, curvature nodes at 0 and 0.2; each node's gains are {kp, kp / 10, kp * 10}.
+*/
+static GainSchedule square()
+{
+    GainSchedule schedule(2u, 100.0, 2u, 0.2, {0.0, 0.0, 0.0});
+    // Speed varies fastest: (0, 0), (100, 0), (0, 0.2), (100, 0.2)
+    const double kp[] = {1.0, 2.0, 3.0, 5.0};
+    std::vector<double> params;
+    for (double p : kp)
+    {
+        params.insert(params.end(), {p, p / 10.0, p * 10.0});
+    }
+    schedule.UpdateParams(params);
+    return schedule;
+}
+
+TEST(GainSchedule, InterpolatesBilinearly)
+{
+    const auto schedule = square();
+    EXPECT_NEAR(1.0, schedule.Lookup(0.0, 0.0)[0], TOLERANCE);
+    EXPECT_NEAR(5.0, schedule.Lookup(100.0, 0.2)[0], TOLERANCE);
+    EXPECT_NEAR(1.5, schedule.Lookup(50.0, 0.0)[0], TOLERANCE);
+    EXPECT_NEAR(2.0, schedule.Lookup(0.0, 0.1)[0], TOLERANCE);
+
+    // 1 + 0.25 * (2 - 1) at curvature 0, 3 + 0.25 * (5 - 3) at 0.2, then 3/4 of the way between them
+    const auto gains = schedule.Lookup(25.0, 0.15);
+    const double expected = 1.25 + 0.75 * (3.5 - 1.25);
+    EXPECT_NEAR(expected, gains[0], TOLERANCE);
+    EXPECT_NEAR(expected / 10.0, gains[1], TOLERANCE);
+    EXPECT_NEAR(expected * 10.0, gains[2], TOLERANCE);
+}
+
+TEST(GainSchedule, ClampsToTheGrid)
+{
+    const auto schedule = square();
+    EXPECT_NEAR(1.0, schedule.Lookup(-20.0, -1.0)[0], TOLERANCE);
+    EXPECT_NEAR(5.0, schedule.Lookup(250.0, 3.0)[0], TOLERANCE);
+    EXPECT_NEAR(2.0, schedule.Lookup(1e300, 0.0)[0], TOLERANCE);
+    EXPECT_NEAR(3.0, schedule.Lookup(-std::numeric_limits<double>::infinity(), 0.2)[0], TOLERANCE);
+}
+
+TEST(GainSchedule, NaNLooksUpTheFirstNode)
+{
+    const auto schedule = square();
+    EXPECT_NEAR(1.0, schedule.Lookup(NAN_VALUE, NAN_VALUE)[0], TOLERANCE);
+    EXPECT_NEAR(2.0, schedule.Lookup(100.0, NAN_VALUE)[0], TOLERANCE);
+    EXPECT_NEAR(3.0, schedule.Lookup(NAN_VALUE, 0.2)[0], TOLERANCE);
+}
+
+TEST(GainSchedule, SingleNodeAxes)
+{
+    GainSchedule schedule(1u, 100.0, 1u, 0.2, {0.1, 0.2, 0.3});
+    ASSERT_EQ(3u, schedule.GetParams().size());
+    const auto gains = schedule.Lookup(70.0, NAN_VALUE);
+    EXPECT_EQ(0.1, gains[0]);
+    EXPECT_EQ(0.2, gains[1]);
+    EXPECT_EQ(0.3, gains[2]);
+}
@@ -0,0 +1,200 @@
+#include <cstdio>
+#include <ftw.h>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "spdlog/sinks/gzip_rotating_file_sink.h"
+
+
+// Each segment holds two 40 byte lines: a third one goes past max_size and rotates
+static constexpr size_t MAX_SIZE = 100u;
+static constexpr size_t MAX_FILES = 3u;
+
+static int removeEntry(const char* path, const struct stat*, int, struct FTW*)
+{
+    return std::remove(path);
+}
+
+class GzipRotatingFileSink : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        char dir[] = "/tmp/pid_gzip_XXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(dir));
+        m_dir = dir;
+    }
+
+    void TearDown() override
+    {
+        nftw(m_dir.c_str(), removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+    }
+
+    std::string path(const std::string& name) const
+    {
+        return m_dir + "/" + name;
+    }
+
+    bool exists(const std::string& name) const
+    {
+        struct stat info;
+        return stat(path(name).c_str(), &info) == 0;
+    }
+
+    std::string read(const std::string& name) const
+    {
+        std::string text;
+        FILE* in = std::fopen(path(name).c_str(), "rb");
+        if (in != nullptr)
+        {
+            char chunk[256];
+            for (size_t read; (read = std::fread(chunk, 1u, sizeof(chunk), in)) > 0u;)
+            {
+                text.append(chunk, read);
+            }
+            std::fclose(in);
+        }
+        return text;
+    }
+
+    std::string gunzip(const std::string& name) const
+    {
+        std::string text;
+        gzFile in = gzopen(path(name).c_str(), "rb");
+        if (in != nullptr)
+        {
+            char chunk[256];
+            for (int read; (read = gzread(in, chunk, sizeof(chunk))) > 0;)
+            {
+                text.append(chunk, static_cast<size_t>(read));
+            }
+            gzclose(in);
+        }
+        return text;
+    }
+
+    void write(const std::string& name, const std::string& text) const
+    {
+        FILE* out = std::fopen(path(name).c_str(), "wb");
+        ASSERT_NE(nullptr, out);
+        std::fputs(text.c_str(), out);
+        std::fclose(out);
+    }
+
+    std::shared_ptr<spdlog::sinks::gzip_rotating_file_sink_st> makeSink()
+    {
+        auto sink = std::make_shared<spdlog::sinks::gzip_rotating_file_sink_st>(path("log.txt"), MAX_SIZE, MAX_FILES);
+        m_logger = std::make_shared<spdlog::logger>("gzip", sink);
+        m_logger->set_pattern("%v");
+        return sink;
+    }
+
+    // Logs lines [first, last) and returns them as they are written
+    std::string log(int first, int last)
+    {
+        std::string lines;
+        for (int i = first; i < last; ++i)
+        {
+            m_logger->info(line(i));
+            lines += line(i) + "\n";
+        }
+        return lines;
+    }
+
+    static std::string line(int i)
+    {
+        return fmt::format("line {:02} {}", i, std::string(31u, 'x'));
+    }
+
+    std::string m_dir;
+    std::shared_ptr<spdlog::logger> m_logger;
+};
+
+TEST_F(GzipRotatingFileSink, CompressesClosedSegments)
+{
+    auto sink = makeSink();
+    const std::string first = log(0, 2);
+    const std::string second = log(2, 4);
+    const std::string current = log(4, 5);
+    sink->wait_compressed();
+
+    EXPECT_FALSE(exists("log.1.txt"));
+    EXPECT_EQ(second, gunzip("log.1.txt.gz"));
+    EXPECT_EQ(first, gunzip("log.2.txt.gz"));
+    m_logger->flush();
+    EXPECT_EQ(current, read("log.txt"));
+}
+
+TEST_F(GzipRotatingFileSink, RemovesTheOldestSegmentAtMaxFiles)
+{
+    auto sink = makeSink();
+    log(0, 2);
+    const std::string second = log(2, 4);
+    const std::string third = log(4, 6);
+    const std::string fourth = log(6, 8);
+    log(8, 9);
+    sink->wait_compressed();
+
+    EXPECT_EQ(fourth, gunzip("log.1.txt.gz"));
+    EXPECT_EQ(third, gunzip("log.2.txt.gz"));
+    EXPECT_EQ(second, gunzip("log.3.txt.gz"));
+    EXPECT_FALSE(exists("log.4.txt.gz"));
+}
+
+TEST_F(GzipRotatingFileSink, KeepsASegmentThatCannotBeCompressed)
+{
+    // gzopen cannot create the temporary .gz over a directory
+    ASSERT_EQ(0, mkdir(path("log.1.txt.gz.tmp").c_str(), 0700));
+    auto sink = makeSink();
+    const std::string first = log(0, 2);
+    const std::string second = log(2, 4);
+    log(4, 5);
+    sink->wait_compressed();
+
+    EXPECT_EQ(first, read("log.1.1.txt"));
+    EXPECT_EQ(second, read("log.1.txt"));
+    EXPECT_FALSE(exists("log.1.txt.gz"));
+
+    // Once compression works again the segment left behind is compressed at the next rotation
+    ASSERT_EQ(0, rmdir(path("log.1.txt.gz.tmp").c_str()));
+    const std::string third = line(4) + "\n" + log(5, 6);
+    log(6, 7);
+    sink->wait_compressed();
+
+    EXPECT_FALSE(exists("log.1.txt"));
+    EXPECT_EQ(second, gunzip("log.2.txt.gz"));
+    EXPECT_EQ(third, gunzip("log.1.txt.gz"));
+    EXPECT_EQ(first, read("log.1.1.txt"));
+}
+
+TEST_F(GzipRotatingFileSink, KeepsAppendingWhenASegmentCanBeNeitherCompressedNorKept)
+{
+    ASSERT_EQ(0, mkdir(path("log.1.txt.gz.tmp").c_str(), 0700));
+    for (int i = 1; i < 1000; ++i)
+    {
+        write(fmt::format("log.1.{}.txt", i), "");
+    }
+    auto sink = makeSink();
+    const std::string first = log(0, 2);
+    const std::string rest = log(2, 5);
+    sink->wait_compressed();
+    m_logger->flush();
+
+    EXPECT_EQ(first, read("log.1.txt"));
+    EXPECT_EQ(rest, read("log.txt"));
+    EXPECT_FALSE(exists("log.1.txt.gz"));
+}
+
+TEST_F(GzipRotatingFileSink, CompressesASegmentLeftByAPreviousRun)
+{
+    write("log.1.txt", "left over\n");
+    auto sink = makeSink();
+    sink->wait_compressed();
+
+    EXPECT_FALSE(exists("log.1.txt"));
+    EXPECT_EQ("left over\n", gunzip("log.1.txt.gz"));
+}
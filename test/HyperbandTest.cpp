@@ -0,0 +1,96 @@
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "Hyperband.h"
+
+using namespace pid_control;
+
+
+/*
+* Runs Hyperband to completion, scoring a candidate by its distance from `target`, and returns the episode
+* length of every evaluation. `params` ends with the final params.
+*/
+static std::vector<unsigned> run(Hyperband& hyperband, std::vector<double>& params, double target)
+{
+    std::vector<unsigned> episodes;
+    bool done = false;
+    while (not done)
+    {
+        episodes.push_back(hyperband.GetEpisodeTicks(1000000u));
+        done = hyperband.runOnce(std::abs(params[0] - target), params);
+    }
+    return episodes;
+}
+
+static std::vector<unsigned> repeat(std::vector<unsigned> episodes, unsigned count, unsigned ticks)
+{
+    episodes.insert(episodes.end(), count, ticks);
+    return episodes;
+}
+
+TEST(Hyperband, BracketSizes)
+{
+    // s_max = 2 for 4000 / 150 with eta 3; bracket s has ceil(3 / (s + 1) * 3^s) candidates of 4000 / 3^s ticks
+    Hyperband hyperband({0.0}, {1.0}, 150u, 4000u, 3u, 1u);
+    std::vector<double> params {0.5};
+    EXPECT_EQ(444u, hyperband.GetEpisodeTicks(4000u));
+
+    std::vector<unsigned> expected;
+    expected = repeat(expected, 9u, 444u);   // s = 2: 9 candidates, then 3, then 1
+    expected = repeat(expected, 3u, 1333u);
+    expected = repeat(expected, 1u, 4000u);
+    expected = repeat(expected, 5u, 1333u);  // s = 1: 5 candidates, then 1
+    expected = repeat(expected, 1u, 4000u);
+    expected = repeat(expected, 3u, 4000u);  // s = 0: 3 candidates
+    EXPECT_EQ(expected, run(hyperband, params, 0.3));
+}
+
+TEST(Hyperband, AtLeastOneHalvingRound)
+{
+    // 400 / 3 is shorter than the minimum, which still leaves one halving round rather than a single candidate
+    Hyperband hyperband({0.0}, {1.0}, 150u, 400u, 3u, 1u);
+    std::vector<double> params {0.0};
+
+    std::vector<unsigned> expected;
+    expected = repeat(expected, 3u, 133u);
+    expected = repeat(expected, 1u, 400u);
+    expected = repeat(expected, 2u, 400u);
+    EXPECT_EQ(expected, run(hyperband, params, 0.3));
+}
+
+TEST(Hyperband, EpisodeTicksAreCappedByTheCaller)
+{
+    Hyperband hyperband({0.0}, {1.0}, 150u, 4000u, 3u, 1u);
+    EXPECT_EQ(300u, hyperband.GetEpisodeTicks(300u));
+}
+
+TEST(Hyperband, FinishesWithTheBestFullLengthCandidate)
+{
+    Hyperband hyperband({0.0}, {1.0}, 150u, 4000u, 3u, 5u);
+    std::vector<double> params {0.5};
+    EXPECT_TRUE(hyperband.GetBestParams().empty());
+
+    double bestFullLength = 1e9;
+    std::vector<double> bestParams;
+    bool done = false;
+    while (not done)
+    {
+        const bool fullLength = hyperband.GetEpisodeTicks(4000u) == 4000u;
+        const double error = std::abs(params[0] - 0.3);
+        if (fullLength && error < bestFullLength)
+        {
+            bestFullLength = error;
+            bestParams = params;
+        }
+        done = hyperband.runOnce(error, params);
+        if (not fullLength && bestParams.empty())
+        {
+            // Short episodes never make a candidate the incumbent
+            EXPECT_TRUE(hyperband.GetBestParams().empty());
+        }
+    }
+    EXPECT_EQ(bestParams, params);
+    EXPECT_EQ(bestParams, hyperband.GetBestParams());
+}
@@ -0,0 +1,92 @@
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+#include "LatencyHistogram.h"
+
+using namespace pid_control;
+
+
+static constexpr uint64_t LARGE_NANOS = 1ull << 60u;
+
+/*
+* The bucket reported for a value, bounded by a much larger value so the maximum does not clip it.
+*/
+static uint64_t bucketUpperBoundOf(uint64_t nanos)
+{
+    LatencyHistogram histogram;
+    histogram.Record(nanos);
+    histogram.Record(LARGE_NANOS);
+    return histogram.Percentile(0.0);
+}
+
+TEST(LatencyHistogram, EmptyReportsZero)
+{
+    LatencyHistogram histogram;
+    EXPECT_EQ(0u, histogram.Count());
+    EXPECT_EQ(0u, histogram.Min());
+    EXPECT_EQ(0u, histogram.Percentile(50.0));
+    EXPECT_EQ(0.0, histogram.Mean());
+}
+
+TEST(LatencyHistogram, SmallValuesAreExact)
+{
+    for (uint64_t nanos = 0u; nanos < 8u; ++nanos)
+    {
+        EXPECT_EQ(nanos, bucketUpperBoundOf(nanos)) << nanos;
+    }
+}
+
+TEST(LatencyHistogram, BucketsBoundValuesWithin25Percent)
+{
+    // Every power of two and its neighbours, and a dense range
+    for (unsigned shift = 2u; shift < 59u; ++shift)
+    {
+        for (int offset = -1; offset <= 1; ++offset)
+        {
+            const uint64_t nanos = (1ull << shift) + offset;
+            const uint64_t bound = bucketUpperBoundOf(nanos);
+            EXPECT_GE(bound, nanos) << nanos;
+            EXPECT_LE(bound - nanos, nanos / 4u) << nanos;
+        }
+    }
+    for (uint64_t nanos = 4u; nanos < 100000u; nanos += 7u)
+    {
+        const uint64_t bound = bucketUpperBoundOf(nanos);
+        EXPECT_GE(bound, nanos) << nanos;
+        EXPECT_LE(bound - nanos, nanos / 4u) << nanos;
+    }
+}
+
+TEST(LatencyHistogram, BucketBoundsAreMonotonic)
+{
+    uint64_t previous = 0u;
+    for (uint64_t nanos = 0u; nanos < 1000000u; nanos += 13u)
+    {
+        const uint64_t bound = bucketUpperBoundOf(nanos);
+        EXPECT_GE(bound, previous) << nanos;
+        previous = bound;
+    }
+}
+
+TEST(LatencyHistogram, PercentilesAreClippedToTheMaximum)
+{
+    LatencyHistogram histogram;
+    for (uint64_t nanos = 1u; nanos <= 100u; ++nanos)
+    {
+        histogram.Record(nanos * 1000u);
+    }
+    EXPECT_EQ(100u, histogram.Count());
+    EXPECT_EQ(1000u, histogram.Min());
+    EXPECT_EQ(100000u, histogram.Max());
+    EXPECT_DOUBLE_EQ(50500.0, histogram.Mean());
+    EXPECT_EQ(100000u, histogram.Percentile(100.0));
+
+    const uint64_t median = histogram.Percentile(50.0);
+    EXPECT_GE(median, 50000u);
+    EXPECT_LE(median, 50000u * 5u / 4u);
+
+    histogram.Reset();
+    EXPECT_EQ(0u, histogram.Count());
+    EXPECT_EQ(0u, histogram.Max());
+}
@@ -0,0 +1,79 @@
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "spdlog/details/mpmc_lockfree_q.h"
+
+using Queue = spdlog::details::mpmc_lockfree_queue<int>;
+
+
+TEST(LogQueue, FirstInFirstOutAndDropsNewestWhenFull)
+{
+    Queue queue(4u);
+    for (int i = 0; i < 6; ++i)
+    {
+        queue.enqueue_nowait(int(i));
+    }
+    EXPECT_EQ(2u, queue.overrun_counter());
+
+    int item = -1;
+    for (int i = 0; i < 4; ++i)
+    {
+        ASSERT_TRUE(queue.dequeue_for(item, std::chrono::milliseconds(0)));
+        EXPECT_EQ(i, item);
+    }
+    EXPECT_FALSE(queue.dequeue_for(item, std::chrono::milliseconds(1)));
+}
+
+TEST(LogQueue, WakesASleepingConsumer)
+{
+    Queue queue(4u);
+    const auto start = std::chrono::steady_clock::now();
+    std::thread producer([&queue]
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        queue.enqueue_nowait(42);
+    });
+
+    int item = 0;
+    EXPECT_TRUE(queue.dequeue_for(item, std::chrono::seconds(10)));
+    producer.join();
+    EXPECT_EQ(42, item);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+TEST(LogQueue, DeliversEveryMessageOfConcurrentProducers)
+{
+    static constexpr int PRODUCERS = 4;
+    static constexpr int MESSAGES = 20000;
+    Queue queue(64u);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p)
+    {
+        producers.emplace_back([&queue, p]
+        {
+            for (int i = 0; i < MESSAGES; ++i)
+            {
+                queue.enqueue(p * MESSAGES + i);
+            }
+        });
+    }
+
+    // Messages of each producer arrive in order
+    std::vector<int> next(PRODUCERS, 0);
+    int item = 0;
+    for (int received = 0; received < PRODUCERS * MESSAGES; ++received)
+    {
+        ASSERT_TRUE(queue.dequeue_for(item, std::chrono::seconds(10)));
+        const int producer = item / MESSAGES;
+        EXPECT_EQ(next[producer]++, item % MESSAGES);
+    }
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+    EXPECT_EQ(0u, queue.overrun_counter());
+}
@@ -0,0 +1,86 @@
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "Options.h"
+
+using namespace pid_control;
+
+
+static bool parse(std::vector<std::string> args, Options& options)
+{
+    args.insert(args.begin(), "pid");
+    std::vector<char*> argv;
+    for (auto& arg : args)
+    {
+        argv.push_back(&arg[0]);
+    }
+    return ParseOptions(static_cast<int>(argv.size()), argv.data(), options);
+}
+
+static bool parse(const std::string& arg)
+{
+    Options options;
+    return parse({arg}, options);
+}
+
+TEST(Options, ParsesValues)
+{
+    Options options;
+    ASSERT_TRUE(parse({"--cpu=3", "--port=8080", "--nominal-tick-ms=12.5", "--tracks=4", "--realtime"}, options));
+    EXPECT_EQ(3, options.cpu);
+    EXPECT_EQ(8080u, options.port);
+    EXPECT_DOUBLE_EQ(12.5, options.nominalTickMs);
+    EXPECT_EQ(4u, options.tracks);
+    EXPECT_TRUE(options.realTime);
+}
+
+TEST(Options, RejectsSignsAndOverflow)
+{
+    EXPECT_FALSE(parse("--cpu=-1"));
+    EXPECT_FALSE(parse("--prefault-mb=-1"));
+    EXPECT_FALSE(parse("--prefault-mb=+1"));
+    EXPECT_FALSE(parse("--prefault-mb= 1"));
+    EXPECT_FALSE(parse("--prefault-mb=4294967296"));
+    EXPECT_FALSE(parse("--prefault-mb=99999999999999999999999"));
+    EXPECT_FALSE(parse("--rt-priority=2147483648"));
+    EXPECT_FALSE(parse("--throttle=1e999"));
+    EXPECT_TRUE(parse("--prefault-mb=4294967295"));
+}
+
+TEST(Options, RejectsOutOfRangeValues)
+{
+    EXPECT_FALSE(parse("--port=70000"));
+    EXPECT_FALSE(parse("--port=0"));
+    EXPECT_FALSE(parse("--nominal-tick-ms=-5"));
+    EXPECT_FALSE(parse("--rt-priority=0"));
+    EXPECT_FALSE(parse("--tracks=0"));
+    EXPECT_FALSE(parse("--tuner-budget=0"));
+    EXPECT_FALSE(parse("--bayes-batch=0"));
+    EXPECT_FALSE(parse("--fork-ticks=0"));
+    EXPECT_FALSE(parse("--adaptive-pole=1"));
+    EXPECT_FALSE(parse("--speed-noise=-0.1"));
+}
+
+TEST(Options, RejectsMalformedArguments)
+{
+    EXPECT_FALSE(parse("--cpu"));
+    EXPECT_FALSE(parse("--cpu=1x"));
+    EXPECT_FALSE(parse("--throttle=fast"));
+    EXPECT_FALSE(parse("--no-such-option"));
+}
+
+TEST(Options, ParsesInitialParams)
+{
+    Options options;
+    ASSERT_TRUE(parse({"--init-params=0.15,0,-0.8"}, options));
+    ASSERT_EQ(3u, options.initParams.size());
+    EXPECT_DOUBLE_EQ(0.15, options.initParams[0]);
+    EXPECT_DOUBLE_EQ(0.0, options.initParams[1]);
+    EXPECT_DOUBLE_EQ(-0.8, options.initParams[2]);
+
+    EXPECT_FALSE(parse("--init-params=0.15,0"));
+    EXPECT_FALSE(parse("--init-params=0.15,0,0.8,1"));
+    EXPECT_FALSE(parse("--init-params=0.15,,0.8"));
+}
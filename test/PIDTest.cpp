@@ -0,0 +1,69 @@
+#include "gtest/gtest.h"
+
+#include "PID.h"
+
+using namespace pid_control;
+
+
+static constexpr double TOLERANCE = 1e-12;
+
+/*
+* Output after `seconds` of a constant error, applied at `hz` ticks per second.
+*/
+static double afterConstantError(double cte, double seconds, unsigned hz)
+{
+    PID pid(0.1, 0.2, 0.5);
+    pid.Reset(cte);
+    const double dt = 1.0 / hz;
+    double value = 0.0;
+    for (unsigned tick = 0u; tick < static_cast<unsigned>(seconds * hz + 0.5); ++tick)
+    {
+        value = pid.Apply(cte, dt);
+    }
+    return value;
+}
+
+TEST(PID, IndependentOfTheTickRate)
+{
+    // -kp * cte - ki * cte * t, and no derivative
+    const double expected = -0.1 * 0.5 - 0.2 * 0.5 * 2.0;
+    EXPECT_NEAR(expected, afterConstantError(0.5, 2.0, 10u), TOLERANCE);
+    EXPECT_NEAR(expected, afterConstantError(0.5, 2.0, 50u), TOLERANCE);
+    EXPECT_NEAR(expected, afterConstantError(0.5, 2.0, 200u), TOLERANCE);
+}
+
+TEST(PID, DerivativeIsTheSlopeOverDt)
+{
+    PID pid(0.0, 0.0, 0.01);
+    pid.Reset(0.0);
+    // 0.2 over 0.1s is a slope of 2
+    EXPECT_NEAR(-0.02, pid.Apply(0.2, 0.1), TOLERANCE);
+    EXPECT_NEAR(-0.02, pid.Apply(0.3, 0.05), TOLERANCE);
+}
+
+TEST(PID, ResetClearsTheDerivativeKickAndTheIntegral)
+{
+    PID pid(0.0, 1.0, 1.0);
+    // Without a reset, the jump from 0 is a large derivative and saturates
+    EXPECT_EQ(-1.0, pid.Apply(0.8, 0.01));
+
+    pid.Reset(0.8);
+    EXPECT_NEAR(-0.8 * 0.01, pid.Apply(0.8, 0.01), TOLERANCE);
+}
+
+TEST(PID, NonPositiveDtKeepsTheState)
+{
+    PID pid(0.5, 1.0, 1.0);
+    pid.Reset(0.0);
+    pid.Apply(0.1, 0.1);
+    // Proportional and the integral so far, no derivative and no accumulation
+    EXPECT_NEAR(-0.5 * 0.3 - 0.1 * 0.1, pid.Apply(0.3, 0.0), TOLERANCE);
+    EXPECT_NEAR(-0.5 * 0.3 - 0.1 * 0.1, pid.Apply(0.3, -1.0), TOLERANCE);
+}
+
+TEST(PID, ClampsTheOutput)
+{
+    PID pid(10.0, 0.0, 0.0);
+    EXPECT_EQ(-1.0, pid.Apply(1.0, 0.1));
+    EXPECT_EQ(1.0, pid.Apply(-1.0, 0.1));
+}
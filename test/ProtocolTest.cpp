@@ -0,0 +1,183 @@
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "FastJson.h"
+#include "Protocol.h"
+
+using namespace pid_control;
+
+
+static std::vector<uint8_t> bytesOf(const fmt::memory_buffer& buffer)
+{
+    return std::vector<uint8_t>(buffer.data(), buffer.data() + buffer.size());
+}
+
+static std::vector<uint8_t> telemetryMsgpack(double cte, double speed, double steeringAngle)
+{
+    fast_json message = fast_json::array();
+    message.push_back("telemetry");
+    message.push_back({{"cte", cte}, {"speed", speed}, {"steering_angle", steeringAngle}});
+    return fast_json::to_msgpack(message);
+}
+
+TEST(Protocol, ParsesItsOwnNames)
+{
+    for (const auto protocol : {WireProtocol::TEXT, WireProtocol::MSGPACK, WireProtocol::STRUCT})
+    {
+        WireProtocol parsed = WireProtocol::TEXT;
+        EXPECT_TRUE(ParseProtocolName(ProtocolName(protocol), parsed));
+        EXPECT_EQ(protocol, parsed);
+    }
+    WireProtocol parsed = WireProtocol::STRUCT;
+    EXPECT_FALSE(ParseProtocolName("protobuf", parsed));
+    EXPECT_EQ(WireProtocol::STRUCT, parsed);
+}
+
+TEST(Protocol, MsgpackSteerMatchesToMsgpack)
+{
+    fmt::memory_buffer out;
+    EncodeSteer(WireProtocol::MSGPACK, -0.25, 0.3, out);
+
+    fast_json expected = fast_json::array();
+    expected.push_back("steer");
+    expected.push_back({{"steering_angle", -0.25}, {"throttle", 0.3}});
+    EXPECT_EQ(fast_json::to_msgpack(expected), bytesOf(out));
+
+    const auto decoded = fast_json::from_msgpack(bytesOf(out));
+    EXPECT_EQ("steer", decoded[0]);
+    EXPECT_EQ(-0.25, decoded[1]["steering_angle"].get<double>());
+    EXPECT_EQ(0.3, decoded[1]["throttle"].get<double>());
+}
+
+TEST(Protocol, MsgpackResetIsAnEmptyMap)
+{
+    fmt::memory_buffer out;
+    EncodeReset(WireProtocol::MSGPACK, out);
+    const auto decoded = fast_json::from_msgpack(bytesOf(out));
+    EXPECT_EQ("reset", decoded[0]);
+    EXPECT_TRUE(decoded[1].is_object());
+    EXPECT_TRUE(decoded[1].empty());
+}
+
+TEST(Protocol, DecodesMsgpackTelemetry)
+{
+    const auto frame = telemetryMsgpack(0.75, 31.5, -3.0);
+    Telemetry telemetry;
+    telemetry.throttle = 1.0;
+    ASSERT_TRUE(DecodeTelemetry(WireProtocol::MSGPACK, reinterpret_cast<const char*>(frame.data()), frame.size(),
+                                telemetry));
+    EXPECT_EQ(0.75, telemetry.cte);
+    EXPECT_EQ(31.5, telemetry.speed);
+    EXPECT_EQ(-3.0, telemetry.steeringAngle);
+    // Optional, and zero when missing
+    EXPECT_EQ(0.0, telemetry.throttle);
+}
+
+TEST(Protocol, DecodesMsgpackTelemetryWithIntegersAndOtherFields)
+{
+    fast_json message = fast_json::array();
+    message.push_back("telemetry");
+    message.push_back({{"cte", 1}, {"speed", 300}, {"steering_angle", -200}, {"image", "base64"}, {"manual", false}});
+    const auto frame = fast_json::to_msgpack(message);
+    Telemetry telemetry;
+    ASSERT_TRUE(DecodeTelemetry(WireProtocol::MSGPACK, reinterpret_cast<const char*>(frame.data()), frame.size(),
+                                telemetry));
+    EXPECT_EQ(1.0, telemetry.cte);
+    EXPECT_EQ(300.0, telemetry.speed);
+    EXPECT_EQ(-200.0, telemetry.steeringAngle);
+}
+
+TEST(Protocol, DecodesMsgpackTelemetryFieldsInAnyOrder)
+{
+    // ["telemetry", {"throttle": 0.5f, "steering_angle": -3, "speed": 30u, "cte": 0.25}]
+    const uint8_t frame[] = {
+        0x92u, 0xa9u, 't', 'e', 'l', 'e', 'm', 'e', 't', 'r', 'y', 0x84u,
+        0xa8u, 't', 'h', 'r', 'o', 't', 't', 'l', 'e', 0xcau, 0x3fu, 0x00u, 0x00u, 0x00u,
+        0xaeu, 's', 't', 'e', 'e', 'r', 'i', 'n', 'g', '_', 'a', 'n', 'g', 'l', 'e', 0xfdu,
+        0xa5u, 's', 'p', 'e', 'e', 'd', 0xccu, 30u,
+        0xa3u, 'c', 't', 'e', 0xcbu, 0x3fu, 0xd0u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+    };
+    Telemetry telemetry;
+    ASSERT_TRUE(DecodeTelemetry(WireProtocol::MSGPACK, reinterpret_cast<const char*>(frame), sizeof(frame), telemetry));
+    EXPECT_EQ(0.25, telemetry.cte);
+    EXPECT_EQ(30.0, telemetry.speed);
+    EXPECT_EQ(-3.0, telemetry.steeringAngle);
+    EXPECT_EQ(0.5, telemetry.throttle);
+}
+
+TEST(Protocol, RejectsMalformedMsgpackTelemetry)
+{
+    Telemetry telemetry;
+
+    fmt::memory_buffer steer;
+    EncodeSteer(WireProtocol::MSGPACK, 0.1, 0.3, steer);
+    EXPECT_FALSE(DecodeTelemetry(WireProtocol::MSGPACK, steer.data(), steer.size(), telemetry));
+
+    const auto frame = telemetryMsgpack(0.75, 31.5, -3.0);
+    EXPECT_FALSE(DecodeTelemetry(WireProtocol::MSGPACK, reinterpret_cast<const char*>(frame.data()), frame.size() - 3u,
+                                 telemetry));
+    EXPECT_FALSE(DecodeTelemetry(WireProtocol::TEXT, reinterpret_cast<const char*>(frame.data()), frame.size(),
+                                 telemetry));
+
+    // A required field missing, or one that is not a number
+    fast_json message = fast_json::array();
+    message.push_back("telemetry");
+    message.push_back({{"cte", 0.75}, {"speed", 31.5}});
+    const auto missing = fast_json::to_msgpack(message);
+    EXPECT_FALSE(DecodeTelemetry(WireProtocol::MSGPACK, reinterpret_cast<const char*>(missing.data()), missing.size(),
+                                 telemetry));
+    message[1]["steering_angle"] = "-3.0";
+    const auto text = fast_json::to_msgpack(message);
+    EXPECT_FALSE(DecodeTelemetry(WireProtocol::MSGPACK, reinterpret_cast<const char*>(text.data()), text.size(),
+                                 telemetry));
+}
+
+TEST(Protocol, StructSteerLayout)
+{
+    fmt::memory_buffer out;
+    EncodeSteer(WireProtocol::STRUCT, 0.5, 0.3, out);
+    ASSERT_EQ(STRUCT_HEADER_BYTES + 2u * sizeof(double), out.size());
+    EXPECT_EQ(static_cast<uint8_t>(StructFrameType::STEER), static_cast<uint8_t>(out.data()[0]));
+    for (size_t i = 1u; i < STRUCT_HEADER_BYTES; ++i)
+    {
+        EXPECT_EQ(0, out.data()[i]);
+    }
+    double values[2];
+    std::memcpy(values, out.data() + STRUCT_HEADER_BYTES, sizeof(values));
+    EXPECT_EQ(0.5, values[0]);
+    EXPECT_EQ(0.3, values[1]);
+
+    fmt::memory_buffer reset;
+    EncodeReset(WireProtocol::STRUCT, reset);
+    ASSERT_EQ(STRUCT_HEADER_BYTES, reset.size());
+    EXPECT_EQ(static_cast<uint8_t>(StructFrameType::RESET), static_cast<uint8_t>(reset.data()[0]));
+}
+
+TEST(Protocol, StructTelemetryRoundTrip)
+{
+    const double values[] = {-1.5, 42.0, 7.25, 0.3};
+    char frame[STRUCT_TELEMETRY_BYTES] = {static_cast<char>(StructFrameType::TELEMETRY)};
+    std::memcpy(frame + STRUCT_HEADER_BYTES, values, sizeof(values));
+
+    Telemetry telemetry;
+    ASSERT_TRUE(DecodeTelemetry(WireProtocol::STRUCT, frame, sizeof(frame), telemetry));
+    EXPECT_EQ(-1.5, telemetry.cte);
+    EXPECT_EQ(42.0, telemetry.speed);
+    EXPECT_EQ(7.25, telemetry.steeringAngle);
+    EXPECT_EQ(0.3, telemetry.throttle);
+
+    EXPECT_FALSE(DecodeTelemetry(WireProtocol::STRUCT, frame, sizeof(frame) - 1u, telemetry));
+    frame[0] = static_cast<char>(StructFrameType::STEER);
+    EXPECT_FALSE(DecodeTelemetry(WireProtocol::STRUCT, frame, sizeof(frame), telemetry));
+}
+
+TEST(Protocol, TextSteer)
+{
+    fmt::memory_buffer out;
+    EncodeSteer(WireProtocol::TEXT, -0.5, 0.3, out);
+    EXPECT_EQ("42[\"steer\",{\"steering_angle\":-0.5,\"throttle\":0.3}]", std::string(out.data(), out.size()));
+}
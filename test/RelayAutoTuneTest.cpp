@@ -0,0 +1,78 @@
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "RelayAutoTune.h"
+
+using namespace pid_control;
+
+
+/*
+* Feeds the relay a sine of the given amplitude and period (in ticks of length dt).
+*/
+static void oscillate(RelayAutoTune& relay, double amplitude, double period, double dt, unsigned ticks)
+{
+    for (unsigned k = 0u; k < ticks; ++k)
+    {
+        relay.Apply(amplitude * std::sin(2.0 * M_PI * k * dt / period), dt);
+    }
+}
+
+TEST(RelayAutoTune, OutputOpposesTheErrorWithHysteresis)
+{
+    RelayAutoTune relay(0.3, 0.05, 4u);
+    EXPECT_DOUBLE_EQ(-0.3, relay.Apply(0.01, 1.0));  // Starts opposing the sign of the error
+    EXPECT_DOUBLE_EQ(-0.3, relay.Apply(-0.04, 1.0)); // Held inside the band
+    EXPECT_DOUBLE_EQ(0.3, relay.Apply(-0.06, 1.0));
+    EXPECT_DOUBLE_EQ(0.3, relay.Apply(0.04, 1.0));
+    EXPECT_DOUBLE_EQ(-0.3, relay.Apply(0.06, 1.0));
+}
+
+TEST(RelayAutoTune, MeasuresThePeriodAndAmplitude)
+{
+    const double amplitude = 0.8;
+    const double period = 40.0;
+    RelayAutoTune relay(0.3, 0.05, 4u);
+    oscillate(relay, amplitude, period, 1.0, 2000u);
+    ASSERT_TRUE(relay.Done());
+
+    EXPECT_NEAR(period, relay.GetUltimatePeriod(), 1e-9);
+    // Ku = 4 h / (pi sqrt(a^2 - hysteresis^2))
+    const double ku = 4.0 * 0.3 / (M_PI * std::sqrt(amplitude * amplitude - 0.05 * 0.05));
+    EXPECT_NEAR(ku, relay.GetUltimateGain(), 0.01 * ku);
+}
+
+TEST(RelayAutoTune, ZieglerNicholsGains)
+{
+    RelayAutoTune relay(0.3, 0.05, 4u);
+    oscillate(relay, 0.8, 40.0, 1.0, 2000u);
+    ASSERT_TRUE(relay.Done());
+
+    const double ku = relay.GetUltimateGain();
+    const double tu = relay.GetUltimatePeriod();
+    const auto gains = relay.GetGains();
+    ASSERT_EQ(3u, gains.size());
+    EXPECT_DOUBLE_EQ(0.6 * ku, gains[0]);
+    EXPECT_DOUBLE_EQ(0.6 * ku / (tu / 2.0), gains[1]);
+    EXPECT_DOUBLE_EQ(0.6 * ku * tu / 8.0, gains[2]);
+}
+
+TEST(RelayAutoTune, PeriodIsInUnitsOfDt)
+{
+    // The same oscillation sampled twice as often, with half the tick length, has the same period
+    RelayAutoTune relay(0.3, 0.05, 4u);
+    oscillate(relay, 0.8, 40.0, 0.5, 4000u);
+    ASSERT_TRUE(relay.Done());
+    EXPECT_NEAR(40.0, relay.GetUltimatePeriod(), 1e-9);
+}
+
+TEST(RelayAutoTune, NotDoneWithoutOscillation)
+{
+    RelayAutoTune relay(0.3, 0.05, 4u);
+    for (unsigned k = 0u; k < 1000u; ++k)
+    {
+        relay.Apply(1.0, 1.0);
+    }
+    EXPECT_FALSE(relay.Done());
+}
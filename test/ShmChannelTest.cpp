@@ -0,0 +1,123 @@
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "ShmChannel.h"
+
+using namespace pid_control;
+
+
+static constexpr auto TIMEOUT = std::chrono::seconds(10);
+
+static std::string segmentName()
+{
+    return "pid_tests_" + std::to_string(getpid());
+}
+
+TEST(ShmChannel, RoundTrip)
+{
+    ShmChannel controller;
+    ASSERT_TRUE(controller.Create(segmentName()));
+    ShmChannel simulator;
+    ASSERT_TRUE(simulator.Open(segmentName()));
+    EXPECT_EQ(1u, controller.Sessions());
+
+    Telemetry telemetry;
+    EXPECT_FALSE(controller.PollTelemetry(telemetry));
+
+    Telemetry sample;
+    sample.cte = 0.5;
+    sample.speed = 30.0;
+    sample.steeringAngle = -2.0;
+    sample.throttle = 0.3;
+    EXPECT_EQ(1u, simulator.PublishTelemetry(sample));
+    ASSERT_TRUE(controller.PollTelemetry(telemetry));
+    EXPECT_EQ(0.5, telemetry.cte);
+    EXPECT_EQ(30.0, telemetry.speed);
+    EXPECT_EQ(-2.0, telemetry.steeringAngle);
+    EXPECT_EQ(0.3, telemetry.throttle);
+    EXPECT_FALSE(controller.PollTelemetry(telemetry));
+
+    ShmCommand command;
+    EXPECT_FALSE(simulator.WaitCommand(1u, command, std::chrono::milliseconds(1)));
+    controller.SendReset();
+    controller.SendSteer(0.25, 0.3);
+    ASSERT_TRUE(simulator.WaitCommand(1u, command, TIMEOUT));
+    EXPECT_EQ(1u, command.tick);
+    EXPECT_EQ(1u, command.resets);
+    EXPECT_EQ(0.25, command.steering);
+    EXPECT_EQ(0.3, command.throttle);
+}
+
+TEST(ShmChannel, RejectsMissingSegment)
+{
+    ShmChannel simulator;
+    EXPECT_FALSE(simulator.Open(segmentName() + "_missing"));
+    EXPECT_FALSE(simulator.IsOpen());
+}
+
+TEST(ShmChannel, NewSessionContinuesTheTicks)
+{
+    ShmChannel controller;
+    ASSERT_TRUE(controller.Create(segmentName()));
+    {
+        ShmChannel simulator;
+        ASSERT_TRUE(simulator.Open(segmentName()));
+        simulator.PublishTelemetry(Telemetry());
+        simulator.PublishTelemetry(Telemetry());
+    }
+    ShmChannel simulator;
+    ASSERT_TRUE(simulator.Open(segmentName()));
+    EXPECT_EQ(2u, controller.Sessions());
+    EXPECT_EQ(3u, simulator.PublishTelemetry(Telemetry()));
+}
+
+/*
+* Every sample has all four values equal, so a read that mixed two writes shows up as unequal values.
+*/
+TEST(ShmChannel, ReadsAreNeverTorn)
+{
+    static constexpr unsigned SAMPLES = 200000u;
+
+    ShmChannel controller;
+    ASSERT_TRUE(controller.Create(segmentName()));
+    ShmChannel simulator;
+    ASSERT_TRUE(simulator.Open(segmentName()));
+
+    std::thread writer([&simulator]
+    {
+        for (unsigned i = 1u; i <= SAMPLES; ++i)
+        {
+            Telemetry sample;
+            sample.cte = sample.speed = sample.steeringAngle = sample.throttle = i;
+            simulator.PublishTelemetry(sample);
+        }
+    });
+
+    unsigned torn = 0u;
+    double last = 0.0;
+    const auto deadline = std::chrono::steady_clock::now() + TIMEOUT;
+    while (last < SAMPLES && std::chrono::steady_clock::now() < deadline)
+    {
+        Telemetry telemetry;
+        if (not controller.PollTelemetry(telemetry))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        if (telemetry.speed != telemetry.cte || telemetry.steeringAngle != telemetry.cte ||
+            telemetry.throttle != telemetry.cte || telemetry.cte <= last)
+        {
+            torn++;
+        }
+        last = telemetry.cte;
+    }
+    writer.join();
+    EXPECT_EQ(0u, torn);
+    EXPECT_EQ(static_cast<double>(SAMPLES), last);
+}
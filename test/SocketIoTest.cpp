@@ -0,0 +1,108 @@
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "SocketIo.h"
+
+using namespace pid_control;
+
+
+/*
+* Records the packets the layer sends and the events it dispatches, with their arguments as strings.
+*/
+class SocketIoTest : public ::testing::Test
+{
+protected:
+    SocketIoTest() :
+        socketIo([this](const char* data, size_t length) { sent.emplace_back(data, length); })
+    {
+        for (const char* name : {"telemetry", "hello"})
+        {
+            socketIo.On(name, [this](const SocketIoEvent& event)
+            {
+                names.emplace_back(event.name, event.nameLength);
+                std::vector<std::string> values;
+                for (size_t i = 0u; i < event.argumentCount; ++i)
+                {
+                    values.emplace_back(event.arguments[i].data, event.arguments[i].length);
+                }
+                arguments.push_back(values);
+            });
+        }
+    }
+
+    void receive(const std::string& message)
+    {
+        socketIo.Receive(message.data(), message.size());
+    }
+
+    SocketIo socketIo;
+    std::vector<std::string> sent;
+    std::vector<std::string> names;
+    std::vector<std::vector<std::string>> arguments;
+};
+
+TEST_F(SocketIoTest, AnswersPingsAndConnects)
+{
+    receive("2probe");
+    receive("40");
+    receive("40/admin,");
+    EXPECT_EQ(std::vector<std::string>({"3probe", "40", "40/admin,"}), sent);
+}
+
+TEST_F(SocketIoTest, DispatchesEventArguments)
+{
+    receive("42[\"telemetry\",{\"cte\":\"0.5\",\"speed\":\"30\"}]");
+    receive("42[ \"hello\" ]");
+    receive("42[\"hello\", {\"a\": [1, 2]}, \"x,]\\\"y\", null ]");
+    receive("42[\"unknown\",1]");
+
+    EXPECT_EQ(std::vector<std::string>({"telemetry", "hello", "hello"}), names);
+    ASSERT_EQ(3u, arguments.size());
+    EXPECT_EQ(std::vector<std::string>({"{\"cte\":\"0.5\",\"speed\":\"30\"}"}), arguments[0]);
+    EXPECT_TRUE(arguments[1].empty());
+    EXPECT_EQ(std::vector<std::string>({"{\"a\": [1, 2]}", "\"x,]\\\"y\"", "null"}), arguments[2]);
+}
+
+TEST_F(SocketIoTest, DropsMalformedEvents)
+{
+    receive("42[\"telemetry\",]");
+    receive("42[\"telemetry\",{\"a\":1]");
+    receive("42[\"telemetry\",\"open]");
+    receive("42[\"telemetry\" 1]");
+    receive("42telemetry");
+    receive("452-[\"telemetry\",{\"_placeholder\":true,\"num\":0}]");
+    EXPECT_TRUE(names.empty());
+}
+
+TEST_F(SocketIoTest, AcknowledgesEventsWithAnId)
+{
+    receive("42/admin,17[\"hello\",1]");
+    EXPECT_EQ(std::vector<std::string>({"43/admin,17[]"}), sent);
+    EXPECT_EQ(std::vector<std::string>({"hello"}), names);
+}
+
+TEST_F(SocketIoTest, SplitsVersion4Payloads)
+{
+    receive("2\x1e" "42[\"hello\",1]\x1e" "42[\"telemetry\",2]");
+    EXPECT_EQ(std::vector<std::string>({"3"}), sent);
+    EXPECT_EQ(std::vector<std::string>({"hello", "telemetry"}), names);
+}
+
+TEST_F(SocketIoTest, CountsVersion3PayloadLengthsInCharacters)
+{
+    // "é" is one character in two bytes, the emoji two UTF-16 units in four bytes
+    receive("1:2" "15:42[\"hello\",\"\xc3\xa9\"]" "16:42[\"hello\",\"\xf0\x9f\x9a\x97\"]");
+    EXPECT_EQ(std::vector<std::string>({"3"}), sent);
+    ASSERT_EQ(2u, arguments.size());
+    EXPECT_EQ(std::vector<std::string>({"\"\xc3\xa9\""}), arguments[0]);
+    EXPECT_EQ(std::vector<std::string>({"\"\xf0\x9f\x9a\x97\""}), arguments[1]);
+}
+
+TEST_F(SocketIoTest, RejectsTruncatedVersion3Payloads)
+{
+    receive("1:2" "16:42[\"hello\",\"\xc3\xa9\"]");
+    EXPECT_EQ(std::vector<std::string>({"3"}), sent);
+    EXPECT_TRUE(names.empty());
+}
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "Protocol.h"
+
+using namespace pid_control;
+
+
+static std::vector<char> telemetryFrame(double cte)
+{
+    std::vector<char> frame(STRUCT_TELEMETRY_BYTES, 0);
+    frame[0] = static_cast<char>(StructFrameType::TELEMETRY);
+    const double values[] = {cte, 30.0, 1.0, 0.3};
+    std::memcpy(frame.data() + STRUCT_HEADER_BYTES, values, sizeof(values));
+    return frame;
+}
+
+/*
+* Receives `length` bytes, as a socket read would.
+*/
+static void receive(StructStreamReader& reader, const char* data, size_t length)
+{
+    ASSERT_LE(length, reader.WriteSpace());
+    std::memcpy(reader.WritePointer(), data, length);
+    reader.Commit(length);
+}
+
+TEST(StructStreamReader, AssemblesFramesSplitAnywhere)
+{
+    std::vector<char> stream;
+    for (int i = 0; i < 3; ++i)
+    {
+        const auto frame = telemetryFrame(i);
+        stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+
+    // Every split point of the stream into two reads
+    for (size_t split = 0u; split <= stream.size(); ++split)
+    {
+        StructStreamReader reader;
+        std::vector<double> decoded;
+        Telemetry telemetry;
+        bool malformed = false;
+
+        receive(reader, stream.data(), split);
+        while (reader.Next(telemetry, malformed))
+        {
+            decoded.push_back(telemetry.cte);
+        }
+        ASSERT_FALSE(malformed);
+        EXPECT_EQ(split / STRUCT_TELEMETRY_BYTES, decoded.size());
+
+        receive(reader, stream.data() + split, stream.size() - split);
+        while (reader.Next(telemetry, malformed))
+        {
+            decoded.push_back(telemetry.cte);
+        }
+        ASSERT_FALSE(malformed);
+        EXPECT_EQ(std::vector<double>({0.0, 1.0, 2.0}), decoded);
+    }
+}
+
+TEST(StructStreamReader, ByteByByte)
+{
+    const auto frame = telemetryFrame(-0.5);
+    StructStreamReader reader;
+    Telemetry telemetry;
+    bool malformed = false;
+    for (size_t i = 0u; i + 1u < frame.size(); ++i)
+    {
+        receive(reader, frame.data() + i, 1u);
+        EXPECT_FALSE(reader.Next(telemetry, malformed));
+        EXPECT_FALSE(malformed);
+    }
+    receive(reader, frame.data() + frame.size() - 1u, 1u);
+    ASSERT_TRUE(reader.Next(telemetry, malformed));
+    EXPECT_EQ(-0.5, telemetry.cte);
+    EXPECT_EQ(30.0, telemetry.speed);
+    EXPECT_EQ(1.0, telemetry.steeringAngle);
+    EXPECT_EQ(0.3, telemetry.throttle);
+}
+
+TEST(StructStreamReader, MovesPartialFramesToMakeRoom)
+{
+    // Far more frames than the buffer holds, each read ending in the middle of a frame
+    const auto frame = telemetryFrame(2.0);
+    std::vector<char> stream;
+    for (int i = 0; i < 1000; ++i)
+    {
+        stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+
+    StructStreamReader reader;
+    Telemetry telemetry;
+    bool malformed = false;
+    size_t received = 0u;
+    size_t frames = 0u;
+    while (received < stream.size())
+    {
+        ASSERT_GT(reader.WriteSpace(), 0u);
+        const size_t length = std::min({reader.WriteSpace(), stream.size() - received, STRUCT_TELEMETRY_BYTES * 5u / 2u});
+        receive(reader, stream.data() + received, length);
+        received += length;
+        while (reader.Next(telemetry, malformed))
+        {
+            frames++;
+            EXPECT_EQ(2.0, telemetry.cte);
+        }
+        ASSERT_FALSE(malformed);
+    }
+    EXPECT_EQ(1000u, frames);
+}
+
+TEST(StructStreamReader, ReportsFramesThatAreNotTelemetry)
+{
+    auto frame = telemetryFrame(0.0);
+    frame[0] = static_cast<char>(StructFrameType::STEER);
+    StructStreamReader reader;
+    receive(reader, frame.data(), frame.size());
+
+    Telemetry telemetry;
+    bool malformed = false;
+    EXPECT_FALSE(reader.Next(telemetry, malformed));
+    EXPECT_TRUE(malformed);
+}
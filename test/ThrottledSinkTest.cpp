@@ -0,0 +1,84 @@
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "spdlog/sinks/ostream_sink.h"
+#include "spdlog/sinks/throttled_sink.h"
+
+
+static size_t countLines(const std::string& text, const std::string& prefix)
+{
+    size_t count = 0u;
+    std::istringstream lines(text);
+    for (std::string line; std::getline(lines, line);)
+    {
+        count += line.compare(0u, prefix.size(), prefix) == 0 ? 1u : 0u;
+    }
+    return count;
+}
+
+TEST(ThrottledSink, LimitsMessagesWithoutSourcePerLoggerAndLevel)
+{
+    std::ostringstream out;
+    auto throttled = std::make_shared<spdlog::sinks::throttled_sink_st>(1.0, 3.0, 1u, std::chrono::seconds(3600));
+    throttled->set_sinks({std::make_shared<spdlog::sinks::ostream_sink_st>(out)});
+    spdlog::logger logger("throttled", throttled);
+    logger.set_pattern("%v");
+
+    for (int i = 0; i < 10; ++i)
+    {
+        logger.warn("tick {}", i);
+        logger.info("other {}", i);
+    }
+    // The burst of each logger and level passes, the rest is counted
+    EXPECT_EQ(3u, countLines(out.str(), "tick"));
+    EXPECT_EQ(3u, countLines(out.str(), "other"));
+
+    logger.flush();
+    EXPECT_NE(std::string::npos, out.str().find("Suppressed 14 messages from 2 sites:"));
+    EXPECT_NE(std::string::npos, out.str().find("throttled/warning x7"));
+}
+
+TEST(ThrottledSink, SamplesCallSites)
+{
+    std::ostringstream out;
+    auto throttled = std::make_shared<spdlog::sinks::throttled_sink_st>(0.0, 0.0, 4u, std::chrono::seconds(3600));
+    throttled->set_sinks({std::make_shared<spdlog::sinks::ostream_sink_st>(out)});
+    spdlog::logger logger("sampled", throttled);
+    logger.set_pattern("%v");
+
+    for (int i = 0; i < 10; ++i)
+    {
+        logger.log(spdlog::source_loc{"Site.cpp", 12, "f"}, spdlog::level::info, "site {}", i);
+    }
+    EXPECT_EQ(3u, countLines(out.str(), "site"));
+    logger.flush();
+    EXPECT_NE(std::string::npos, out.str().find("Site.cpp:12 x7"));
+}
+
+TEST(ThrottledSink, SummarizesWithoutFurtherMessages)
+{
+    std::ostringstream out;
+    auto target = std::make_shared<spdlog::sinks::ostream_sink_mt>(out);
+    auto throttled = std::make_shared<spdlog::sinks::throttled_sink_mt>(0.0, 0.0, 2u, std::chrono::seconds(1));
+    throttled->set_sinks({target});
+    spdlog::logger logger("timed", throttled);
+    logger.set_pattern("%v");
+
+    logger.info("first");
+    logger.info("second");
+
+    // The timer logs the summary about a second later; nothing is flushed or logged meanwhile
+    std::string logged;
+    for (int i = 0; i < 50 && logged.find("Suppressed") == std::string::npos; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        target->flush();
+        logged = out.str();
+    }
+    EXPECT_NE(std::string::npos, logged.find("Suppressed 1 messages from 1 sites: timed/info x1"));
+}
@@ -0,0 +1,104 @@
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "TraceDecode.h"
+#include "TraceLog.h"
+
+using namespace pid_control;
+
+
+static std::string tempPath()
+{
+    char path[] = "/tmp/pid_trace_XXXXXX";
+    const int fd = mkstemp(path);
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    return path;
+}
+
+static std::vector<std::string> decode(const std::string& path, std::string& error)
+{
+    std::vector<std::string> lines;
+    FILE* in = std::fopen(path.c_str(), "rb");
+    if (in == nullptr)
+    {
+        error = "could not open";
+        return lines;
+    }
+    DecodeTrace(in, [&lines](const std::string& line) { lines.push_back(line); }, error);
+    std::fclose(in);
+    return lines;
+}
+
+// The decoded text after the elapsed time prefix
+static std::string text(const std::string& line)
+{
+    return line.substr(line.find(' ') + 1u);
+}
+
+TEST(TraceLog, RoundTripsRecordsThroughTheDecoder)
+{
+    const std::string path = tempPath();
+    TraceLog trace;
+    const uint16_t cte = trace.Register("cte={:.2f}");
+    const uint16_t gains = trace.Register("p={} i={} d={}");
+    ASSERT_TRUE(trace.Open(path));
+    trace.Log(cte, 0.5);
+    trace.Log(gains, 0.25, 0.0, 3.0);
+    trace.Log(cte, -1.0);
+    trace.Close();
+    EXPECT_EQ(0u, trace.Dropped());
+
+    std::string error;
+    const std::vector<std::string> lines = decode(path, error);
+    EXPECT_TRUE(error.empty());
+    ASSERT_EQ(3u, lines.size());
+    EXPECT_EQ("0.000000 cte=0.50", lines[0]);
+    EXPECT_EQ("p=0.25 i=0 d=3", text(lines[1]));
+    EXPECT_EQ("cte=-1.00", text(lines[2]));
+    std::remove(path.c_str());
+}
+
+TEST(TraceLog, DecodesABadFormatAsTheRawFormatAndValues)
+{
+    const std::string path = tempPath();
+    TraceLog trace;
+    const uint16_t stray = trace.Register("cte={");
+    const uint16_t integer = trace.Register("speed={:d}");
+    ASSERT_TRUE(trace.Open(path));
+    trace.Log(stray, 0.5);
+    trace.Log(integer, 28.5);
+    trace.Log(static_cast<uint16_t>(7u), 1.0);
+    trace.Close();
+
+    std::string error;
+    const std::vector<std::string> lines = decode(path, error);
+    ASSERT_EQ(3u, lines.size());
+    EXPECT_EQ("Bad format \"cte={\": 0.5", text(lines[0]));
+    EXPECT_EQ("Bad format \"speed={:d}\": 28.5", text(lines[1]));
+    EXPECT_EQ("Unknown format 7", text(lines[2]));
+    std::remove(path.c_str());
+}
+
+TEST(TraceLog, RejectsAFileThatIsNotATrace)
+{
+    const std::string path = tempPath();
+    FILE* out = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(nullptr, out);
+    std::fputs("not a trace", out);
+    std::fclose(out);
+
+    std::string error;
+    FILE* in = std::fopen(path.c_str(), "rb");
+    ASSERT_NE(nullptr, in);
+    EXPECT_FALSE(DecodeTrace(in, [](const std::string&) {}, error));
+    std::fclose(in);
+    EXPECT_FALSE(error.empty());
+    std::remove(path.c_str());
+}
@@ -0,0 +1,88 @@
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "Track.h"
+
+using namespace pid_control;
+
+
+static constexpr size_t NO_HINT = std::numeric_limits<size_t>::max();
+
+/*
+* Unsigned distance to the nearest segment, by scanning all of them.
+*/
+static double bruteForceDistance(const Track& track, double x, double y)
+{
+    double best = std::numeric_limits<double>::max();
+    for (size_t i = 0u; i < track.Segments(); ++i)
+    {
+        const Point& a = track.Start(i);
+        const Point& b = track.Start((i + 1u) % track.Segments());
+        const double dx = b.x - a.x;
+        const double dy = b.y - a.y;
+        const double t = std::min(std::max(((x - a.x) * dx + (y - a.y) * dy) / (dx * dx + dy * dy), 0.0), 1.0);
+        best = std::min(best, std::hypot(x - a.x - t * dx, y - a.y - t * dy));
+    }
+    return best;
+}
+
+TEST(Track, SignedDistanceToASquare)
+{
+    // Counterclockwise, so the outside of the loop is to the right of the driving direction
+    const Track track({{0.0, 0.0}, {100.0, 0.0}, {100.0, 100.0}, {0.0, 100.0}});
+    size_t segment = NO_HINT;
+    EXPECT_DOUBLE_EQ(1.0, track.Cte(50.0, -1.0, segment));
+    EXPECT_EQ(0u, segment);
+    EXPECT_DOUBLE_EQ(-2.0, track.Cte(50.0, 2.0, segment));
+    EXPECT_DOUBLE_EQ(3.0, track.Cte(103.0, 40.0, segment));
+    EXPECT_EQ(1u, segment);
+    EXPECT_NEAR(0.0, track.Heading(0), 1e-12);
+    EXPECT_NEAR(M_PI / 2.0, track.Heading(1), 1e-12);
+}
+
+TEST(Track, GridMatchesBruteForce)
+{
+    std::mt19937 rng(3u);
+    for (unsigned seed = 0u; seed < 4u; ++seed)
+    {
+        const Track track = seed == 0u ? Track::Default() : Track::Generate(seed);
+        std::uniform_real_distribution<double> coordinate(-400.0, 400.0);
+        for (unsigned i = 0u; i < 2000u; ++i)
+        {
+            // Points all over and beyond the track's bounding box, which fall back to scanning
+            const double x = coordinate(rng);
+            const double y = coordinate(rng);
+            size_t segment = NO_HINT;
+            EXPECT_NEAR(bruteForceDistance(track, x, y), std::abs(track.Cte(x, y, segment)), 1e-9) << x << ", " << y;
+            ASSERT_LT(segment, track.Segments());
+        }
+    }
+}
+
+TEST(Track, HintWalkMatchesBruteForceAlongTheTrack)
+{
+    const Track track = Track::Generate(11u);
+    std::mt19937 rng(5u);
+    std::uniform_real_distribution<double> offset(-4.0, 4.0);
+
+    // A car weaving along the track, with the previous tick's segment as the hint
+    size_t segment = 0u;
+    for (size_t i = 0u; i < 3u * track.Segments(); ++i)
+    {
+        const Point& a = track.Start(i % track.Segments());
+        const double heading = track.Heading(i % track.Segments());
+        const double lateral = offset(rng);
+        const double x = a.x + std::sin(heading) * lateral;
+        const double y = a.y - std::cos(heading) * lateral;
+        EXPECT_NEAR(bruteForceDistance(track, x, y), std::abs(track.Cte(x, y, segment)), 1e-9) << i;
+    }
+
+    // A stale hint from the other side of the track
+    const Point& far = track.Start(track.Segments() / 2u);
+    segment = 0u;
+    EXPECT_NEAR(bruteForceDistance(track, far.x, far.y), std::abs(track.Cte(far.x, far.y, segment)), 1e-9);
+}
@@ -0,0 +1,76 @@
+#include <cstdio>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "UnixSocketTransport.h"
+
+using namespace pid_control;
+
+
+static std::string tempPath()
+{
+    char path[] = "/tmp/pid_unix_XXXXXX";
+    const int fd = mkstemp(path);
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    return path;
+}
+
+static bool isSocket(const std::string& path)
+{
+    struct stat info;
+    return lstat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode);
+}
+
+static bool exists(const std::string& path)
+{
+    struct stat info;
+    return lstat(path.c_str(), &info) == 0;
+}
+
+TEST(UnixSocketTransport, RemovesItsSocketFile)
+{
+    const std::string path = tempPath();
+    std::remove(path.c_str());
+    {
+        UnixSocketTransport transport(path);
+        ASSERT_TRUE(transport.Listen());
+        EXPECT_TRUE(isSocket(path));
+    }
+    EXPECT_FALSE(exists(path));
+}
+
+TEST(UnixSocketTransport, ReplacesASocketLeftByAPreviousRun)
+{
+    const std::string path = tempPath();
+    std::remove(path.c_str());
+    {
+        UnixSocketTransport previous(path);
+        ASSERT_TRUE(previous.Listen());
+        // Left behind as if the previous run had crashed
+        ASSERT_EQ(0, link(path.c_str(), (path + ".left").c_str()));
+    }
+    ASSERT_EQ(0, rename((path + ".left").c_str(), path.c_str()));
+    ASSERT_TRUE(isSocket(path));
+
+    UnixSocketTransport transport(path);
+    EXPECT_TRUE(transport.Listen());
+}
+
+TEST(UnixSocketTransport, KeepsAFileThatIsNotASocket)
+{
+    const std::string path = tempPath();
+    {
+        UnixSocketTransport transport(path);
+        EXPECT_FALSE(transport.Listen());
+    }
+    // Neither Listen nor the destructor removed the regular file
+    EXPECT_TRUE(exists(path));
+    EXPECT_FALSE(isSocket(path));
+    std::remove(path.c_str());
+}